@@ -1,13 +1,30 @@
 // file: graph_compare.c
+#define _POSIX_C_SOURCE 200809L // posix_memalign
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
 #include <time.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "graphfile.h"
 
 #define N 100
 #define SPARSE_E 100
 #define DENSE_E 4000
+#define ADJ_INLINE 8   // neighbors stored inline before a vertex gets a hash set
+#define DYN_TOMBSTONE(v) (~(v))  // deleted v keeps its sorted place as ~v (< 0)
+#define DYN_KEY(x) ((x) < 0 ? ~(x) : (x))
+#define DYN_COMPACT_RATIO 0.25 // compact when tombstones exceed this share of slots
+#define GB_MM_STRIPE 64        // C columns per Four Russians table, in words (4096 columns)
+#define GB_MM_ROW_BLOCK 1024   // rows of C per thread task
 
 typedef struct Node {
     int v;
@@ -25,6 +42,102 @@ typedef struct {
     size_t node_count; // how many Node allocated (for memory calc)
 } GraphList;
 
+// Bit-packed matrix: row u is words_per_row 64-bit words (64-byte aligned)
+typedef struct {
+    int n;
+    size_t words_per_row; // ceil(n/64) rounded up to 8 words = one cache line
+    uint64_t* bits;
+} GraphBitMatrix;
+
+// Compressed sparse row: neighbors of u are nbrs[offsets[u] .. offsets[u+1])
+typedef struct {
+    int n;
+    int64_t* offsets; // size n+1
+    int* nbrs;        // size offsets[n], both directions of every edge
+    int sorted;       // lists ascending -> binary search in has_edge
+    GraphFileView* file; // non-NULL: offsets/nbrs point into a mapped file (read-only)
+} GraphCSR;
+
+// Per-vertex neighbor set: up to ADJ_INLINE ids inline (linear scan), then
+// an open-addressing table (linear probing, -1 = empty)
+typedef struct {
+    int deg;
+    int cap;            // 0 = inline mode, else table size (power of two)
+    union {
+        int inl[ADJ_INLINE];
+        int* table;
+    } s;
+} AdjSet;
+
+typedef struct {
+    int n;
+    AdjSet* adj;        // size n
+    size_t table_bytes; // bytes held by promoted tables (for memory calc)
+} GraphHashSet;
+
+// Hybrid: each vertex is a sorted int array while its degree is low and a
+// bitset row once the array would be larger than the row (deg > n/32)
+typedef struct {
+    int deg;
+    int cap;            // sorted-array capacity, or -1 when stored as a bitset row
+    union {
+        int* arr;
+        uint64_t* row;
+    } s;
+} HybridAdj;
+
+typedef struct {
+    int n;
+    size_t row_words;   // ceil(n/64)
+    int up_deg;         // array -> bitset when deg exceeds this
+    int down_deg;       // bitset -> array when deg drops below this (hysteresis)
+    HybridAdj* adj;     // size n
+    size_t heap_bytes;  // arrays + rows currently allocated (for memory calc)
+    int rows;           // vertices currently stored as bitset rows
+} GraphHybrid;
+
+// Dynamic adjacency for batched updates: per-vertex arrays sorted by
+// DYN_KEY, where deleted entries become DYN_TOMBSTONE(v) until the next
+// compaction
+typedef struct {
+    int* v;
+    int len;            // used slots, live + tombstones
+    int cap;
+    int live;
+} DynAdj;
+
+typedef struct {
+    int n;
+    DynAdj* adj;        // size n
+    long long slots;    // sum of len
+    long long tombstones;
+    int compactions;
+} GraphDyn;
+
+typedef struct { int u, v, op; } EdgeUpdate;    // op: 1 = insert, 0 = delete
+
+// Read-only compressed CSR: list u starts at data[offsets[u]] with
+// varint(degree), zigzag varint(first - u), then the remaining gaps in
+// Stream VByte form (one control byte of 2-bit lengths per 4 gaps, then the
+// gaps' 1-4 little-endian bytes)
+typedef struct {
+    int n;
+    int max_degree;
+    int64_t half_edges;
+    int64_t* offsets;   // size n+1, byte positions in data
+    uint8_t* data;      // offsets[n] bytes + 16 bytes slack for vector loads
+} GraphCompressed;
+
+// Streaming neighbor iterator over one compressed list, 4 gaps at a time
+typedef struct {
+    const uint8_t* ctrl;
+    const uint8_t* data;
+    int left;           // gaps not decoded yet
+    int next, filled;   // position in buf
+    uint32_t prev;
+    uint32_t buf[4];
+} GzIter;
+
 typedef struct {
     unsigned long long insert_cmp;
     unsigned long long delete_cmp;
@@ -36,28 +149,156 @@ typedef struct {
 
 typedef struct { int u, v; } Edge;
 
-static void shuffle_edges(Edge* arr, size_t m) {
+// splitmix64: 64-bit generator; distinct seeds give independent streams
+typedef struct { uint64_t s; } Rng;
+
+static uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static void rng_seed(Rng* r, uint64_t seed, uint64_t stream) {
+    r->s = mix64(seed ^ mix64(stream + 0x9E3779B97F4A7C15ULL));
+}
+
+static uint64_t rng_next(Rng* r) {
+    return mix64(r->s += 0x9E3779B97F4A7C15ULL);
+}
+
+// uniform in [0, n) without modulo bias
+static uint64_t rng_below(Rng* r, uint64_t n) {
+    uint64_t lim = UINT64_MAX - UINT64_MAX % n, x;
+    do { x = rng_next(r); } while (x >= lim);
+    return x % n;
+}
+
+static uint64_t atomic_cas_u64(volatile uint64_t* p, uint64_t expected, uint64_t desired) {
+#ifdef _MSC_VER
+    return (uint64_t)_InterlockedCompareExchange64((volatile __int64*)p, (__int64)desired, (__int64)expected);
+#else
+    return __sync_val_compare_and_swap(p, expected, desired);
+#endif
+}
+
+static int max_threads(void) {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+static void shuffle_edges(Edge* arr, size_t m, Rng* r) {
     for (size_t i = m - 1; i > 0; --i) {
-        size_t j = (size_t)(rand() % (int)(i + 1));
+        size_t j = (size_t)rng_below(r, i + 1);
         Edge tmp = arr[i]; arr[i] = arr[j]; arr[j] = tmp;
     }
 }
 
-// Generate exactly E unique undirected edges among n vertices, no self-loops
-static Edge* generate_random_edge_set(int n, int E) {
+// Open-addressing set of undirected pair keys u*n+v (stored +1, 0 = empty).
+// Inserts are lock-free (CAS), so several threads can share one table.
+typedef struct {
+    uint64_t* slots;
+    uint64_t mask;
+} EdgeKeySet;
+
+static void eks_init(EdgeKeySet* s, size_t expected) {
+    size_t cap = 16;
+    while (cap < expected * 2) cap <<= 1;  // load factor <= 0.5
+    s->slots = (uint64_t*)calloc(cap, sizeof(uint64_t));
+    if (!s->slots) { fprintf(stderr, "edge set: out of memory (%zu slots)\n", cap); exit(1); }
+    s->mask = cap - 1;
+}
+
+// returns 1 if key was newly inserted
+static int eks_insert(EdgeKeySet* s, uint64_t key) {
+    uint64_t k = key + 1;
+    for (uint64_t h = mix64(key) & s->mask;; h = (h + 1) & s->mask) {
+        uint64_t cur = s->slots[h];
+        if (cur == 0) cur = atomic_cas_u64(&s->slots[h], 0, k);
+        if (cur == 0) return 1;
+        if (cur == k) return 0;
+    }
+}
+
+static int eks_contains(const EdgeKeySet* s, uint64_t key) {
+    uint64_t k = key + 1;
+    for (uint64_t h = mix64(key) & s->mask;; h = (h + 1) & s->mask) {
+        if (s->slots[h] == k) return 1;
+        if (s->slots[h] == 0) return 0;
+    }
+}
+
+// Draw `want` distinct random pairs u < v into out[], thread t filling its
+// own slice with its own RNG stream. Any stopping rule that only looks at
+// how many distinct pairs were found keeps the result a uniform subset.
+static void sample_distinct_pairs(int n, size_t want, uint64_t seed, int threads,
+    EdgeKeySet* set, Edge* out) {
+#ifndef _OPENMP
+    (void)threads;
+#endif
+#pragma omp parallel num_threads(threads) if(threads > 1)
+    {
+        int t = 0, T = 1;
+#ifdef _OPENMP
+        t = omp_get_thread_num();
+        T = omp_get_num_threads();
+#endif
+        size_t begin = want * t / T, end = want * (t + 1) / T;
+        Rng r;
+        rng_seed(&r, seed, (uint64_t)t);
+        while (begin < end) {
+            int u = (int)rng_below(&r, (uint64_t)n);
+            int v = (int)rng_below(&r, (uint64_t)n);
+            if (u == v) continue;
+            if (u > v) { int tmp = u; u = v; v = tmp; }
+            if (eks_insert(set, (uint64_t)u * n + v)) out[begin++] = (Edge){ u, v };
+        }
+    }
+}
+
+// G(n, m) sampler: exactly E unique undirected edges, no self-loops, in
+// O(E) time and memory (hashed rejection). Above half density it samples
+// the complement instead, where enumerating all pairs is itself O(E).
+// threads <= 0 uses every available thread.
+static Edge* sample_gnm_edges(int n, int E, uint64_t seed, int threads) {
     size_t all = (size_t)n * (n - 1) / 2;
-    Edge* pool = (Edge*)malloc(all * sizeof(Edge));
-    size_t idx = 0;
-    for (int i = 0; i < n; ++i)
-        for (int j = i + 1; j < n; ++j)
-            pool[idx++] = (Edge){ i, j };
-    shuffle_edges(pool, all);
-    Edge* chosen = (Edge*)malloc(E * sizeof(Edge));
-    for (int k = 0; k < E; ++k) chosen[k] = pool[k];
-    free(pool);
+    if (E < 0 || (size_t)E > all) {
+        fprintf(stderr, "cannot place %d edges on %d vertices (max %zu)\n", E, n, all);
+        exit(1);
+    }
+    if (threads <= 0) threads = max_threads();
+    Edge* chosen = (Edge*)malloc((size_t)E * sizeof(Edge) + sizeof(Edge));
+    if (!chosen) { fprintf(stderr, "sampler: out of memory for %d edges\n", E); exit(1); }
+    EdgeKeySet set;
+    if ((size_t)E <= all / 2) {
+        eks_init(&set, (size_t)E);
+        sample_distinct_pairs(n, (size_t)E, seed, threads, &set, chosen);
+    }
+    else {
+        size_t skip = all - (size_t)E, k = 0;
+        Edge* excluded = (Edge*)malloc(skip * sizeof(Edge) + sizeof(Edge));
+        eks_init(&set, skip);
+        sample_distinct_pairs(n, skip, seed, threads, &set, excluded);
+        free(excluded);
+        for (int i = 0; i < n; ++i)
+            for (int j = i + 1; j < n; ++j)
+                if (!eks_contains(&set, (uint64_t)i * n + j)) chosen[k++] = (Edge){ i, j };
+        Rng r;
+        rng_seed(&r, seed, UINT64_MAX);
+        if (E > 1) shuffle_edges(chosen, (size_t)E, &r);
+    }
+    free(set.slots);
     return chosen;
 }
 
+// Generate exactly E unique undirected edges among n vertices, no self-loops
+static Edge* generate_random_edge_set(int n, int E) {
+    uint64_t seed = ((uint64_t)rand() << 32) ^ (uint64_t)rand();
+    return sample_gnm_edges(n, E, seed, 1);
+}
+
 /* ---------- Graph (Matrix) ---------- */
 
 static GraphMatrix* gm_create(int n) {
@@ -110,6 +351,252 @@ static size_t gm_memory_bytes(GraphMatrix* g) {
     return sizeof(GraphMatrix) + (size_t)g->n * g->n * sizeof(uint8_t);
 }
 
+/* ---------- Bit helpers ---------- */
+
+static void* aligned_calloc64(size_t bytes) {
+    void* p = NULL;
+#ifdef _MSC_VER
+    p = _aligned_malloc(bytes, 64);
+#else
+    if (posix_memalign(&p, 64, bytes) != 0) p = NULL;
+#endif
+    if (p) memset(p, 0, bytes);
+    return p;
+}
+
+static void aligned_free64(void* p) {
+#ifdef _MSC_VER
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+static int bit_ctz64(uint64_t x) {
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return (int)i;
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+static int bit_popcount64(uint64_t x) {
+#ifdef _MSC_VER
+    return (int)__popcnt64(x);
+#else
+    return __builtin_popcountll(x);
+#endif
+}
+
+/* ---------- Graph (Bit-packed Matrix) ---------- */
+
+static GraphBitMatrix* gb_create(int n) {
+    GraphBitMatrix* g = (GraphBitMatrix*)malloc(sizeof(GraphBitMatrix));
+    g->n = n;
+    g->words_per_row = (((size_t)n + 63) / 64 + 7) & ~(size_t)7;
+    g->bits = (uint64_t*)aligned_calloc64((size_t)n * g->words_per_row * sizeof(uint64_t) + 64);
+    return g;
+}
+
+static void gb_free(GraphBitMatrix* g) {
+    if (!g) return;
+    aligned_free64(g->bits);
+    free(g);
+}
+
+static uint64_t* gb_row(const GraphBitMatrix* g, int u) {
+    return g->bits + (size_t)u * g->words_per_row;
+}
+
+static void gb_add_edge(GraphBitMatrix* g, int u, int v, CmpCounter* cc) {
+    cc->insert_cmp++;     // test the existing bit
+    if (!(gb_row(g, u)[v >> 6] >> (v & 63) & 1)) {
+        gb_row(g, u)[v >> 6] |= 1ULL << (v & 63);
+        gb_row(g, v)[u >> 6] |= 1ULL << (u & 63);
+    }
+}
+
+static void gb_remove_edge(GraphBitMatrix* g, int u, int v, CmpCounter* cc) {
+    cc->delete_cmp++;
+    if (gb_row(g, u)[v >> 6] >> (v & 63) & 1) {
+        gb_row(g, u)[v >> 6] &= ~(1ULL << (v & 63));
+        gb_row(g, v)[u >> 6] &= ~(1ULL << (u & 63));
+    }
+}
+
+static int gb_has_edge(GraphBitMatrix* g, int u, int v, CmpCounter* cc) {
+    cc->check_cmp++;
+    return (int)(gb_row(g, u)[v >> 6] >> (v & 63) & 1);
+}
+
+static void gb_print_neighbors(GraphBitMatrix* g, int u, CmpCounter* cc) {
+    // comparisons = one zero-test per 64-bit word, then ctz per set bit
+    const uint64_t* row = gb_row(g, u);
+    size_t words = ((size_t)g->n + 63) / 64;
+    for (size_t w = 0; w < words; ++w) {
+        cc->print_cmp++;
+        for (uint64_t x = row[w]; x; x &= x - 1) {
+            int j = (int)(w * 64) + bit_ctz64(x);
+            (void)j; // printf("%d ", j);
+        }
+    }
+    // printf("\n");
+}
+
+static int gb_degree(const GraphBitMatrix* g, int u) {
+    const uint64_t* row = gb_row(g, u);
+    int d = 0;
+    for (size_t w = 0; w < g->words_per_row; ++w) d += bit_popcount64(row[w]);
+    return d;
+}
+
+// dst = a | b and dst = a & b over whole rows (rows are 64-byte aligned and
+// a multiple of 8 words long, so the vector loops need no tail handling)
+static void gb_row_or(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t words) {
+#if defined(__AVX2__)
+    for (size_t w = 0; w < words; w += 4)
+        _mm256_store_si256((__m256i*)(dst + w), _mm256_or_si256(
+            _mm256_load_si256((const __m256i*)(a + w)), _mm256_load_si256((const __m256i*)(b + w))));
+#elif defined(__SSE2__)
+    for (size_t w = 0; w < words; w += 2)
+        _mm_store_si128((__m128i*)(dst + w), _mm_or_si128(
+            _mm_load_si128((const __m128i*)(a + w)), _mm_load_si128((const __m128i*)(b + w))));
+#else
+    for (size_t w = 0; w < words; ++w) dst[w] = a[w] | b[w];
+#endif
+}
+
+static void gb_row_and(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t words) {
+#if defined(__AVX2__)
+    for (size_t w = 0; w < words; w += 4)
+        _mm256_store_si256((__m256i*)(dst + w), _mm256_and_si256(
+            _mm256_load_si256((const __m256i*)(a + w)), _mm256_load_si256((const __m256i*)(b + w))));
+#elif defined(__SSE2__)
+    for (size_t w = 0; w < words; w += 2)
+        _mm_store_si128((__m128i*)(dst + w), _mm_and_si128(
+            _mm_load_si128((const __m128i*)(a + w)), _mm_load_si128((const __m128i*)(b + w))));
+#else
+    for (size_t w = 0; w < words; ++w) dst[w] = a[w] & b[w];
+#endif
+}
+
+// |N(u) & N(v)| with one row AND plus popcount
+static int gb_common_neighbors(const GraphBitMatrix* g, int u, int v, uint64_t* scratch) {
+    int c = 0;
+    gb_row_and(scratch, gb_row(g, u), gb_row(g, v), g->words_per_row);
+    for (size_t w = 0; w < g->words_per_row; ++w) c += bit_popcount64(scratch[w]);
+    return c;
+}
+
+static size_t gb_memory_bytes(GraphBitMatrix* g) {
+    return sizeof(GraphBitMatrix) + (size_t)g->n * g->words_per_row * sizeof(uint64_t);
+}
+
+static long long gb_count_bits(const GraphBitMatrix* g) {
+    long long c = 0;
+    for (size_t w = 0; w < (size_t)g->n * g->words_per_row; ++w) c += bit_popcount64(g->bits[w]);
+    return c;
+}
+
+/* ---------- Boolean matrix multiply (bit-packed) ---------- */
+
+// C = A * B over the boolean semiring; C must not alias A or B.
+// Rows of C are split into GB_MM_ROW_BLOCK tasks. Inside a task, each group
+// of 8 B rows (one byte of every A row) is applied either directly (OR the
+// B row for every set bit) or, when the block's set bits outweigh 256 ORs,
+// through a Four Russians table of all 256 unions of those 8 rows, built one
+// GB_MM_STRIPE column stripe at a time so it stays cache resident.
+static void gb_multiply(const GraphBitMatrix* A, const GraphBitMatrix* B, GraphBitMatrix* C) {
+    int n = A->n;
+    size_t W = A->words_per_row;
+    int blocks = (n + GB_MM_ROW_BLOCK - 1) / GB_MM_ROW_BLOCK;
+    memset(C->bits, 0, (size_t)n * W * sizeof(uint64_t));
+#pragma omp parallel
+    {
+        uint64_t* table = (uint64_t*)aligned_calloc64((size_t)256 * GB_MM_STRIPE * sizeof(uint64_t));
+        int* rows = (int*)malloc(GB_MM_ROW_BLOCK * sizeof(int));
+        uint8_t* bytes = (uint8_t*)malloc(GB_MM_ROW_BLOCK);
+#pragma omp for schedule(dynamic, 1)
+        for (int b = 0; b < blocks; ++b) {
+            int r0 = b * GB_MM_ROW_BLOCK, r1 = r0 + GB_MM_ROW_BLOCK < n ? r0 + GB_MM_ROW_BLOCK : n;
+            for (int k0 = 0; k0 < n; k0 += 8) {
+                int active = 0, weight = 0, kbits = n - k0 < 8 ? n - k0 : 8;
+                for (int i = r0; i < r1; ++i) {
+                    uint8_t x = ((const uint8_t*)gb_row(A, i))[k0 / 8];  // little-endian words
+                    if (x) { rows[active] = i; bytes[active++] = x; weight += bit_popcount64(x); }
+                }
+                if (active == 0) continue;
+                if (weight <= 256 + active) {
+                    for (int a = 0; a < active; ++a)
+                        for (unsigned x = bytes[a]; x; x &= x - 1) {
+                            uint64_t* c = gb_row(C, rows[a]);
+                            gb_row_or(c, c, gb_row(B, k0 + bit_ctz64(x)), W);
+                        }
+                    continue;
+                }
+                for (size_t s0 = 0; s0 < W; s0 += GB_MM_STRIPE) {
+                    size_t len = W - s0 < GB_MM_STRIPE ? W - s0 : GB_MM_STRIPE;
+                    // table[j] = table[j without its lowest bit] | B row of that bit
+                    memset(table, 0, len * sizeof(uint64_t));
+                    for (int j = 1; j < (1 << kbits); ++j)
+                        gb_row_or(table + (size_t)j * GB_MM_STRIPE, table + (size_t)(j & (j - 1)) * GB_MM_STRIPE,
+                            gb_row(B, k0 + bit_ctz64((uint64_t)j)) + s0, len);
+                    for (int a = 0; a < active; ++a) {
+                        uint64_t* c = gb_row(C, rows[a]) + s0;
+                        gb_row_or(c, c, table + (size_t)bytes[a] * GB_MM_STRIPE, len);
+                    }
+                }
+            }
+        }
+        aligned_free64(table);
+        free(rows);
+        free(bytes);
+    }
+}
+
+// 2-hop relation: bit (u, w) set when some v has u-v and v-w
+static GraphBitMatrix* gb_two_hop(const GraphBitMatrix* g) {
+    GraphBitMatrix* c = gb_create(g->n);
+    gb_multiply(g, g, c);
+    return c;
+}
+
+// Reachability within k steps: (I | A)^k by repeated squaring, so
+// O(log k) multiplies instead of k
+static GraphBitMatrix* gb_reach_within(const GraphBitMatrix* g, int k) {
+    int n = g->n;
+    size_t bytes = (size_t)n * g->words_per_row * sizeof(uint64_t);
+    GraphBitMatrix* p = gb_create(n);
+    GraphBitMatrix* tmp = gb_create(n);
+    GraphBitMatrix* result = NULL;
+    memcpy(p->bits, g->bits, bytes);
+    for (int u = 0; u < n; ++u) gb_row(p, u)[u / 64] |= 1ULL << (u % 64);
+    if (k <= 0) {
+        memset(p->bits, 0, bytes);
+        for (int u = 0; u < n; ++u) gb_row(p, u)[u / 64] |= 1ULL << (u % 64);
+        gb_free(tmp);
+        return p;
+    }
+    for (;;) {
+        if (k & 1) {
+            if (!result) { result = gb_create(n); memcpy(result->bits, p->bits, bytes); }
+            else {
+                gb_multiply(result, p, tmp);
+                GraphBitMatrix* t = result; result = tmp; tmp = t;
+            }
+        }
+        k >>= 1;
+        if (!k) break;
+        gb_multiply(p, p, tmp);
+        GraphBitMatrix* t = p; p = tmp; tmp = t;
+    }
+    gb_free(p);
+    gb_free(tmp);
+    return result;
+}
+
 /* ---------- Graph (Adjacency List) ---------- */
 
 static GraphList* gl_create(int n) {
@@ -202,140 +689,2514 @@ static size_t gl_memory_bytes(GraphList* g) {
     return sizeof(GraphList) + (size_t)g->n * sizeof(Node*) + g->node_count * sizeof(Node);
 }
 
-/* ---------- Build graphs from edge set ---------- */
+/* ---------- Graph (CSR) ---------- */
 
-static GraphMatrix* build_matrix_from_edges(int n, Edge* edges, int E) {
-    GraphMatrix* gm = gm_create(n);
-    CmpCounter tmp = { 0 };
-    for (int i = 0; i < E; ++i) gm_add_edge(gm, edges[i].u, edges[i].v, &tmp);
-    return gm;
+static void gc_free(GraphCSR* g) {
+    if (!g) return;
+    if (g->file) {
+        gf_close(g->file);
+        free(g->file);
+    }
+    else {
+        free(g->offsets);
+        free(g->nbrs);
+    }
+    free(g);
 }
 
-static GraphList* build_list_from_edges(int n, Edge* edges, int E) {
-    GraphList* gl = gl_create(n);
-    CmpCounter tmp = { 0 };
-    for (int i = 0; i < E; ++i) gl_add_edge(gl, edges[i].u, edges[i].v, &tmp);
-    return gl;
+// Read-only CSR view over a graphfile.h file; nothing is parsed or copied
+static GraphCSR* gc_open_file(const char* path, int verify) {
+    GraphFileView* v = (GraphFileView*)malloc(sizeof(GraphFileView));
+    if (gf_open(path, v, verify) != 0) { free(v); return NULL; }
+    if (v->n > (uint64_t)INT32_MAX - 1) {
+        fprintf(stderr, "%s: %llu vertices do not fit an int id\n", path, (unsigned long long)v->n);
+        gf_close(v);
+        free(v);
+        return NULL;
+    }
+    GraphCSR* g = (GraphCSR*)malloc(sizeof(GraphCSR));
+    g->n = (int)v->n;
+    g->offsets = (int64_t*)v->offsets;
+    g->nbrs = (int*)v->nbrs;
+    g->sorted = (v->flags & GF_SORTED) != 0;
+    g->file = v;
+    return g;
 }
 
-/* ---------- Experiment runners ---------- */
-
-static void make_random_pair(int n, int* u, int* v) {
-    do {
-        *u = rand() % n;
-        *v = rand() % n;
-    } while (*u == *v);
-    if (*u > *v) { int t = *u; *u = *v; *v = t; }
+static int gc_save_file(const GraphCSR* g, const char* path) {
+    return gf_write(path, (uint64_t)g->n, g->offsets, (const int32_t*)g->nbrs, NULL,
+        GF_UNDIRECTED | (g->sorted ? GF_SORTED : 0));
 }
 
-static void run_case_matrix(const char* title, int n, Edge* base_edges, int E) {
-    GraphMatrix* g = build_matrix_from_edges(n, base_edges, E);
-    CmpCounter cc = { 0 };
+static int cmp_int_asc(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
 
-    // 1) Memory
-    size_t mem = gm_memory_bytes(g);
+// short neighbor lists: insertion sort beats qsort's call overhead
+static void sort_ints(int* a, size_t n) {
+    if (n > 32) { qsort(a, n, sizeof(int), cmp_int_asc); return; }
+    for (size_t i = 1; i < n; ++i) {
+        int x = a[i];
+        size_t j = i;
+        while (j > 0 && a[j - 1] > x) { a[j] = a[j - 1]; --j; }
+        a[j] = x;
+    }
+}
 
-    // 2) Insert/Delete comparisons: do T trials with non-existing random edges (insert then delete)
-    const int Tio = 100;
-    for (int t = 0; t < Tio; ++t) {
-        int u, v;
-        // find a non-edge to insert (limit attempts)
-        for (int tries = 0; tries < 10000; ++tries) {
-            make_random_pair(n, &u, &v);
-            CmpCounter tmp = { 0 };
-            if (!gm_has_edge(g, u, v, &tmp)) { // count check comps in cc.insert_cmp? keep separate: not required
-                // add then remove (measure comparisons inside add/remove)
-                gm_add_edge(g, u, v, &cc);
-                gm_remove_edge(g, u, v, &cc);
-                break;
-            }
+static int gc_has_edge(GraphCSR* g, int u, int v, CmpCounter* cc) {
+    int64_t lo = g->offsets[u], hi = g->offsets[u + 1];
+    if (g->sorted) {
+        while (lo < hi) {
+            int64_t mid = lo + (hi - lo) / 2;
+            cc->check_cmp++;          // compare nbrs[mid] with v
+            if (g->nbrs[mid] == v) return 1;
+            if (g->nbrs[mid] < v) lo = mid + 1;
+            else hi = mid;
         }
+        return 0;
     }
-
-    // 3) Connectivity check comparisons: random pairs
-    const int Tc = 100;
-    for (int t = 0; t < Tc; ++t) {
-        int u, v; make_random_pair(n, &u, &v);
-        gm_has_edge(g, u, v, &cc);
+    for (; lo < hi; ++lo) {
+        cc->check_cmp++;
+        if (g->nbrs[lo] == v) return 1;
     }
+    return 0;
+}
 
-    // 4) Print neighbors comparisons: random nodes
-    const int Tp = 10;
-    for (int t = 0; t < Tp; ++t) {
-        int u = rand() % n;
-        gm_print_neighbors(g, u, &cc);
+static void gc_print_neighbors(GraphCSR* g, int u, CmpCounter* cc) {
+    for (int64_t i = g->offsets[u]; i < g->offsets[u + 1]; ++i) {
+        cc->print_cmp++;  // one per neighbor visited, same as the list
+        // printf("%d ", g->nbrs[i]);
     }
+    // printf("\n");
+}
 
-    printf("%s\n", title);
-    printf("Memory: %zu Bytes\n", mem);
-    printf("Edge insert/delete comparisons (total over %d ops): %llu\n", Tio * 2, cc.insert_cmp + cc.delete_cmp);
-    printf("Connectivity checks (total over %d ops): %llu\n", Tc, cc.check_cmp);
-    printf("Print neighbors comparisons (total over %d ops): %llu\n", Tp, cc.print_cmp);
-    printf("\n");
+static size_t gc_memory_bytes(GraphCSR* g) {
+    return sizeof(GraphCSR) + (size_t)(g->n + 1) * sizeof(int64_t)
+        + (size_t)g->offsets[g->n] * sizeof(int);
+}
 
-    gm_free(g);
+/* ---------- Graph (Compressed CSR) ---------- */
+
+static uint8_t svb_shuf[256][16];   // pshufb masks per control byte
+static uint8_t svb_len[256];        // data bytes per control byte
+
+static int svb_code(uint32_t x) { return x < (1u << 8) ? 0 : x < (1u << 16) ? 1 : x < (1u << 24) ? 2 : 3; }
+
+static int varint_bytes(uint32_t x) {
+    int b = 1;
+    while (x >= 0x80) { x >>= 7; ++b; }
+    return b;
 }
 
-static void run_case_list(const char* title, int n, Edge* base_edges, int E) {
-    GraphList* g = build_list_from_edges(n, base_edges, E);
-    CmpCounter cc = { 0 };
+static uint8_t* varint_put(uint8_t* p, uint32_t x) {
+    while (x >= 0x80) { *p++ = (uint8_t)(x | 0x80); x >>= 7; }
+    *p++ = (uint8_t)x;
+    return p;
+}
 
-    // 1) Memory
-    size_t mem = gl_memory_bytes(g);
+static const uint8_t* varint_get(const uint8_t* p, uint32_t* x) {
+    if (*p < 0x80) { *x = *p; return p + 1; }   // degrees and first deltas are mostly < 128
+    uint32_t r = 0;
+    for (int shift = 0;; shift += 7) {
+        uint8_t b = *p++;
+        r |= (uint32_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) break;
+    }
+    *x = r;
+    return p;
+}
 
-    // 2) Insert/Delete comparisons: do T trials with non-existing edges
-    const int Tio = 100;
-    for (int t = 0; t < Tio; ++t) {
-        int u, v;
-        // choose a non-edge to insert, ensure uniqueness
-        for (int tries = 0; tries < 10000; ++tries) {
-            make_random_pair(g->n, &u, &v);
-            CmpCounter tmp = { 0 };
-            if (!gl_has_edge(g, u, v, &tmp)) {
-                gl_add_edge(g, u, v, &cc);
-                gl_remove_edge(g, u, v, &cc);
-                break;
-            }
-        }
+static uint32_t zigzag32(int32_t x) { return ((uint32_t)x << 1) ^ (uint32_t)(x >> 31); }
+static int32_t unzigzag32(uint32_t x) { return (int32_t)(x >> 1) ^ -(int32_t)(x & 1); }
+
+// Encoded size of a sorted list of u (gaps wrap mod 2^32, so any order decodes)
+static size_t gz_list_bytes(int u, const int* l, int deg) {
+    size_t bytes = (size_t)varint_bytes((uint32_t)deg);
+    if (deg == 0) return bytes;
+    bytes += (size_t)varint_bytes(zigzag32(l[0] - u)) + (size_t)(deg - 1 + 3) / 4;
+    for (int i = 1; i < deg; ++i) bytes += (size_t)svb_code((uint32_t)l[i] - (uint32_t)l[i - 1]) + 1;
+    return bytes;
+}
+
+static void gz_encode_list(int u, const int* l, int deg, uint8_t* p) {
+    p = varint_put(p, (uint32_t)deg);
+    if (deg == 0) return;
+    p = varint_put(p, zigzag32(l[0] - u));
+    uint8_t* ctrl = p;
+    uint8_t* data = p + (deg - 1 + 3) / 4;
+    memset(ctrl, 0, (size_t)(deg - 1 + 3) / 4);
+    for (int i = 1; i < deg; ++i) {
+        uint32_t gap = (uint32_t)l[i] - (uint32_t)l[i - 1];
+        int code = svb_code(gap);
+        ctrl[(i - 1) / 4] |= (uint8_t)(code << (2 * ((i - 1) % 4)));
+        for (int b = 0; b <= code; ++b) *data++ = (uint8_t)(gap >> (8 * b));
+    }
+}
+
+// Decode `count` gaps (any number; groups of 4 share a control byte),
+// prefix-summed onto prev. One unaligned 4-byte load per gap (little-endian;
+// data has 16 bytes slack). Returns the data pointer past the last gap.
+static const uint8_t* svb_decode_scalar(const uint8_t* ctrl, const uint8_t* data, int count,
+    uint32_t prev, uint32_t* out) {
+    static const uint32_t mask[4] = { 0xffu, 0xffffu, 0xffffffu, 0xffffffffu };
+    for (int k = 0; k < count; ++k) {
+        int code = (ctrl[k >> 2] >> (2 * (k & 3))) & 3;
+        uint32_t word;
+        memcpy(&word, data, sizeof(word));
+        data += code + 1;
+        prev += word & mask[code];
+        out[k] = prev;
     }
+    return data;
+}
 
-    // 3) Connectivity check comparisons
-    const int Tc = 100;
-    for (int t = 0; t < Tc; ++t) {
-        int u, v; make_random_pair(g->n, &u, &v);
-        gl_has_edge(g, u, v, &cc);
+static const uint8_t* svb_decode_full_scalar(const uint8_t* ctrl, const uint8_t* data, int groups,
+    uint32_t prev, uint32_t* out) {
+    return svb_decode_scalar(ctrl, data, 4 * groups, prev, out);
+}
+
+#if defined(__SSSE3__) || (defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)))
+#define SVB_SSSE3 1
+#ifdef __SSSE3__
+#define SVB_TARGET
+#else
+#define SVB_TARGET __attribute__((target("ssse3")))   // built without -mssse3: dispatch at run time
+#endif
+// `groups` full groups of 4: per control byte one pshufb from the mask table,
+// two shifted adds for the in-register prefix sum, and a lane-3 broadcast
+// that carries the running value into the next group without a store/load.
+SVB_TARGET
+static const uint8_t* svb_decode_full_ssse3(const uint8_t* ctrl, const uint8_t* data, int groups,
+    uint32_t prev, uint32_t* out) {
+    __m128i run = _mm_set1_epi32((int)prev);
+    for (int i = 0; i < groups; ++i) {
+        uint8_t c = ctrl[i];
+        __m128i x = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)data),
+            _mm_loadu_si128((const __m128i*)svb_shuf[c]));
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+        run = _mm_add_epi32(x, run);
+        _mm_storeu_si128((__m128i*)(out + 4 * i), run);
+        run = _mm_shuffle_epi32(run, 0xff);
+        data += svb_len[c];
     }
+    return data;
+}
+#endif
 
-    // 4) Print neighbors comparisons
-    const int Tp = 10;
-    for (int t = 0; t < Tp; ++t) {
-        int u = rand() % g->n;
-        gl_print_neighbors(g, u, &cc);
+// Full-group decoder picked once by svb_init (SSSE3 when the CPU has it)
+static const uint8_t* (*svb_decode_full)(const uint8_t*, const uint8_t*, int, uint32_t, uint32_t*)
+    = svb_decode_full_scalar;
+
+static const char* svb_decoder_name(void) {
+    return svb_decode_full == svb_decode_full_scalar ? "scalar" : "SSSE3";
+}
+
+static void svb_init(void) {
+    static int ready = 0;
+    if (ready) return;
+    for (int c = 0; c < 256; ++c) {
+        int pos = 0;
+        for (int k = 0; k < 4; ++k) {
+            int len = ((c >> (2 * k)) & 3) + 1;
+            for (int b = 0; b < 4; ++b) svb_shuf[c][4 * k + b] = b < len ? (uint8_t)(pos + b) : 0x80;
+            pos += len;
+        }
+        svb_len[c] = (uint8_t)pos;
     }
+#if defined(SVB_SSSE3) && defined(__SSSE3__)
+    svb_decode_full = svb_decode_full_ssse3;
+#elif defined(SVB_SSSE3)
+    if (__builtin_cpu_supports("ssse3")) svb_decode_full = svb_decode_full_ssse3;
+#endif
+    ready = 1;
+}
 
-    printf("%s\n", title);
-    printf("Memory: %zu Bytes\n", mem);
-    printf("Edge insert/delete comparisons (total over %d ops): %llu\n", Tio * 2, cc.insert_cmp + cc.delete_cmp);
-    printf("Connectivity checks (total over %d ops): %llu\n", Tc, cc.check_cmp);
-    printf("Print neighbors comparisons (total over %d ops): %llu\n", Tp, cc.print_cmp);
-    printf("\n");
+static void gz_free(GraphCompressed* g) {
+    if (!g) return;
+    free(g->offsets);
+    free(g->data);
+    free(g);
+}
 
-    gl_free(g);
+static void gz_iter_begin(const GraphCompressed* g, int u, GzIter* it) {
+    uint32_t deg, first;
+    const uint8_t* p = varint_get(g->data + g->offsets[u], &deg);
+    it->next = it->filled = 0;
+    it->left = 0;
+    if (deg == 0) return;
+    p = varint_get(p, &first);
+    it->prev = it->buf[0] = (uint32_t)(u + unzigzag32(first));
+    it->filled = 1;
+    it->left = (int)deg - 1;
+    it->ctrl = p;
+    it->data = p + (it->left + 3) / 4;
 }
 
-int main(void) {
-    srand((unsigned)time(NULL));
+static int gz_iter_next(GzIter* it, int* v) {
+    if (it->next == it->filled) {
+        if (it->left == 0) return 0;
+        int k = it->left < 4 ? it->left : 4;
+        it->data = k == 4 ? svb_decode_full(it->ctrl, it->data, 1, it->prev, it->buf)
+                          : svb_decode_scalar(it->ctrl, it->data, k, it->prev, it->buf);
+        it->ctrl++;
+        it->prev = it->buf[k - 1];
+        it->left -= k;
+        it->filled = k;
+        it->next = 0;
+    }
+    *v = (int)it->buf[it->next++];
+    return 1;
+}
+
+// Bulk decode of list u; out needs room for degree + 3 ints. Returns degree.
+static int gz_decode_list(const GraphCompressed* g, int u, int* out) {
+    uint32_t deg, first;
+    const uint8_t* p = varint_get(g->data + g->offsets[u], &deg);
+    if (deg == 0) return 0;
+    p = varint_get(p, &first);
+    uint32_t prev = (uint32_t)(u + unzigzag32(first));
+    out[0] = (int)prev;
+    int gaps = (int)deg - 1, groups = gaps / 4;
+    const uint8_t* ctrl = p;
+    const uint8_t* data = p + (gaps + 3) / 4;
+    if (groups > 0) {
+        data = svb_decode_full(ctrl, data, groups, prev, (uint32_t*)out + 1);
+        prev = (uint32_t)out[4 * groups];
+    }
+    if (gaps & 3) svb_decode_scalar(ctrl + groups, data, gaps & 3, prev, (uint32_t*)out + 1 + 4 * groups);
+    return (int)deg;
+}
+
+static int gz_degree(const GraphCompressed* g, int u) {
+    uint32_t deg;
+    varint_get(g->data + g->offsets[u], &deg);
+    return (int)deg;
+}
+
+// Lists are ascending, so the walk stops at the first neighbor >= v
+static int gz_has_edge(const GraphCompressed* g, int u, int v, CmpCounter* cc) {
+    GzIter it;
+    int w;
+    gz_iter_begin(g, u, &it);
+    while (gz_iter_next(&it, &w)) {
+        cc->check_cmp++;
+        if (w >= v) return w == v;
+    }
+    return 0;
+}
+
+static size_t gz_memory_bytes(const GraphCompressed* g) {
+    return sizeof(GraphCompressed) + (size_t)(g->n + 1) * sizeof(int64_t) + (size_t)g->offsets[g->n];
+}
+
+/* ---------- Graph (Per-vertex Hash Set) ---------- */
+
+static uint32_t adj_slot(int v, int cap) {
+    return (uint32_t)mix64((uint64_t)(uint32_t)v) & (uint32_t)(cap - 1);
+}
+
+// probe for v; returns table index of v, or -(index of empty slot) - 1
+static int adj_probe(const AdjSet* a, int v, unsigned long long* cmp_slot) {
+    for (uint32_t h = adj_slot(v, a->cap);; h = (h + 1) & (uint32_t)(a->cap - 1)) {
+        int cur = a->s.table[h];
+        if (cur == -1) return -(int)h - 1;
+        (*cmp_slot)++;                // compare slot with v
+        if (cur == v) return (int)h;
+    }
+}
+
+static int adj_contains(const AdjSet* a, int v, unsigned long long* cmp_slot) {
+    if (a->cap == 0) {
+        for (int i = 0; i < a->deg; ++i) {
+            (*cmp_slot)++;
+            if (a->s.inl[i] == v) return 1;
+        }
+        return 0;
+    }
+    return adj_probe(a, v, cmp_slot) >= 0;
+}
+
+// move every element into a fresh table of size cap (inline -> table or grow)
+static void adj_rehash(GraphHashSet* g, AdjSet* a, int cap) {
+    int* table = (int*)malloc((size_t)cap * sizeof(int));
+    int old_cap = a->cap, * old = NULL, tmp[ADJ_INLINE], count = 0;
+    memset(table, 0xff, (size_t)cap * sizeof(int));
+    if (old_cap == 0) { memcpy(tmp, a->s.inl, (size_t)a->deg * sizeof(int)); count = a->deg; }
+    else old = a->s.table;
+    a->s.table = table;
+    a->cap = cap;
+    unsigned long long dummy = 0;
+    if (old) {
+        for (int i = 0; i < old_cap; ++i)
+            if (old[i] != -1) table[-adj_probe(a, old[i], &dummy) - 1] = old[i];
+        free(old);
+        g->table_bytes -= (size_t)old_cap * sizeof(int);
+    }
+    else {
+        for (int i = 0; i < count; ++i) table[-adj_probe(a, tmp[i], &dummy) - 1] = tmp[i];
+    }
+    g->table_bytes += (size_t)cap * sizeof(int);
+}
+
+// shrink a table back to the inline array once it is small again
+static void adj_demote(GraphHashSet* g, AdjSet* a) {
+    int* old = a->s.table, cap = a->cap, k = 0;
+    for (int i = 0; i < cap; ++i)
+        if (old[i] != -1) a->s.inl[k++] = old[i];
+    a->cap = 0;
+    free(old);
+    g->table_bytes -= (size_t)cap * sizeof(int);
+}
+
+// insert v, duplicate check included; returns 1 if inserted
+static int adj_insert(GraphHashSet* g, AdjSet* a, int v, unsigned long long* cmp_slot) {
+    if (adj_contains(a, v, cmp_slot)) return 0;
+    if (a->cap == 0 && a->deg < ADJ_INLINE) {
+        a->s.inl[a->deg++] = v;
+        return 1;
+    }
+    if (a->cap == 0) adj_rehash(g, a, ADJ_INLINE * 4);
+    else if ((a->deg + 1) * 2 > a->cap) adj_rehash(g, a, a->cap * 2); // load <= 0.5
+    unsigned long long dummy = 0;
+    a->s.table[-adj_probe(a, v, &dummy) - 1] = v;
+    a->deg++;
+    return 1;
+}
+
+static int adj_remove(GraphHashSet* g, AdjSet* a, int v, unsigned long long* cmp_slot) {
+    if (a->cap == 0) {
+        for (int i = 0; i < a->deg; ++i) {
+            (*cmp_slot)++;
+            if (a->s.inl[i] == v) { a->s.inl[i] = a->s.inl[--a->deg]; return 1; }
+        }
+        return 0;
+    }
+    int h = adj_probe(a, v, cmp_slot);
+    if (h < 0) return 0;
+    // backward-shift deletion keeps probe chains intact without tombstones
+    uint32_t mask = (uint32_t)(a->cap - 1), hole = (uint32_t)h, j = hole;
+    for (;;) {
+        j = (j + 1) & mask;
+        int cur = a->s.table[j];
+        if (cur == -1) break;
+        uint32_t home = adj_slot(cur, a->cap);
+        if (((j - home) & mask) >= ((j - hole) & mask)) {
+            a->s.table[hole] = cur;
+            hole = j;
+        }
+    }
+    a->s.table[hole] = -1;
+    a->deg--;
+    if (a->deg < ADJ_INLINE / 2) adj_demote(g, a);
+    return 1;
+}
+
+static GraphHashSet* gs_create(int n) {
+    GraphHashSet* g = (GraphHashSet*)malloc(sizeof(GraphHashSet));
+    g->n = n;
+    g->adj = (AdjSet*)calloc(n, sizeof(AdjSet));
+    g->table_bytes = 0;
+    return g;
+}
+
+static void gs_free(GraphHashSet* g) {
+    if (!g) return;
+    for (int i = 0; i < g->n; ++i)
+        if (g->adj[i].cap) free(g->adj[i].s.table);
+    free(g->adj);
+    free(g);
+}
+
+static void gs_add_edge(GraphHashSet* g, int u, int v, CmpCounter* cc) {
+    // duplicate check happens on u's side only (sets are kept symmetric)
+    if (adj_insert(g, &g->adj[u], v, &cc->insert_cmp)) {
+        unsigned long long dummy = 0;
+        adj_insert(g, &g->adj[v], u, &dummy);
+    }
+}
+
+static void gs_remove_edge(GraphHashSet* g, int u, int v, CmpCounter* cc) {
+    adj_remove(g, &g->adj[u], v, &cc->delete_cmp);
+    adj_remove(g, &g->adj[v], u, &cc->delete_cmp);
+}
+
+static int gs_has_edge(GraphHashSet* g, int u, int v, CmpCounter* cc) {
+    return adj_contains(&g->adj[u], v, &cc->check_cmp);
+}
+
+static void gs_print_neighbors(GraphHashSet* g, int u, CmpCounter* cc) {
+    const AdjSet* a = &g->adj[u];
+    if (a->cap == 0) {
+        for (int i = 0; i < a->deg; ++i) cc->print_cmp++;  // printf("%d ", a->s.inl[i]);
+        return;
+    }
+    for (int i = 0; i < a->cap; ++i) {
+        cc->print_cmp++;              // test slot for empty
+        // if (a->s.table[i] != -1) printf("%d ", a->s.table[i]);
+    }
+}
+
+static size_t gs_memory_bytes(GraphHashSet* g) {
+    return sizeof(GraphHashSet) + (size_t)g->n * sizeof(AdjSet) + g->table_bytes;
+}
+
+/* ---------- Graph (Hybrid: sorted array / bitset row per vertex) ---------- */
+
+static GraphHybrid* gh_create(int n) {
+    GraphHybrid* g = (GraphHybrid*)malloc(sizeof(GraphHybrid));
+    g->n = n;
+    g->row_words = ((size_t)n + 63) / 64;
+    // a row costs 8*row_words bytes, an array 4*deg: switch where they cross
+    g->up_deg = (int)(g->row_words * 2);
+    g->down_deg = (int)g->row_words;
+    g->adj = (HybridAdj*)calloc(n, sizeof(HybridAdj));
+    g->heap_bytes = 0;
+    g->rows = 0;
+    return g;
+}
+
+static void gh_free(GraphHybrid* g) {
+    if (!g) return;
+    for (int i = 0; i < g->n; ++i) free(g->adj[i].cap < 0 ? (void*)g->adj[i].s.row : (void*)g->adj[i].s.arr);
+    free(g->adj);
+    free(g);
+}
+
+// lower bound of v in a sorted array, counting comparisons
+static int gh_lower_bound(const HybridAdj* a, int v, unsigned long long* cmp_slot) {
+    int lo = 0, hi = a->deg;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        (*cmp_slot)++;                // compare arr[mid] with v
+        if (a->s.arr[mid] < v) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static int gh_has_edge_oneway(const GraphHybrid* g, int u, int v, unsigned long long* cmp_slot) {
+    const HybridAdj* a = &g->adj[u];
+    if (a->cap < 0) {
+        (*cmp_slot)++;                // test one bit
+        return (int)(a->s.row[v >> 6] >> (v & 63) & 1);
+    }
+    int i = gh_lower_bound(a, v, cmp_slot);
+    return i < a->deg && a->s.arr[i] == v;
+}
+
+static void gh_to_row(GraphHybrid* g, HybridAdj* a) {
+    uint64_t* row = (uint64_t*)calloc(g->row_words, sizeof(uint64_t));
+    for (int i = 0; i < a->deg; ++i) row[a->s.arr[i] >> 6] |= 1ULL << (a->s.arr[i] & 63);
+    g->heap_bytes += g->row_words * sizeof(uint64_t) - (size_t)a->cap * sizeof(int);
+    free(a->s.arr);
+    a->s.row = row;
+    a->cap = -1;
+    g->rows++;
+}
+
+static void gh_to_array(GraphHybrid* g, HybridAdj* a) {
+    int cap = a->deg < 4 ? 4 : a->deg * 2, k = 0;
+    int* arr = (int*)malloc((size_t)cap * sizeof(int));
+    for (size_t w = 0; w < g->row_words; ++w)
+        for (uint64_t x = a->s.row[w]; x; x &= x - 1) arr[k++] = (int)(w * 64) + bit_ctz64(x);
+    g->heap_bytes += (size_t)cap * sizeof(int) - g->row_words * sizeof(uint64_t);
+    free(a->s.row);
+    a->s.arr = arr;
+    a->cap = cap;
+    g->rows--;
+}
+
+// v is known to be absent from u's set
+static void gh_insert_oneway(GraphHybrid* g, int u, int v) {
+    HybridAdj* a = &g->adj[u];
+    if (a->cap < 0) {
+        a->s.row[v >> 6] |= 1ULL << (v & 63);
+        a->deg++;
+        return;
+    }
+    unsigned long long dummy = 0;
+    int pos = gh_lower_bound(a, v, &dummy);
+    if (a->deg == a->cap) {
+        int cap = a->cap ? a->cap * 2 : 4;
+        a->s.arr = (int*)realloc(a->s.arr, (size_t)cap * sizeof(int));
+        g->heap_bytes += (size_t)(cap - a->cap) * sizeof(int);
+        a->cap = cap;
+    }
+    memmove(a->s.arr + pos + 1, a->s.arr + pos, (size_t)(a->deg - pos) * sizeof(int));
+    a->s.arr[pos] = v;
+    a->deg++;
+    if (a->deg > g->up_deg) gh_to_row(g, a);
+}
+
+static int gh_remove_oneway(GraphHybrid* g, int u, int v, unsigned long long* cmp_slot) {
+    HybridAdj* a = &g->adj[u];
+    if (a->cap < 0) {
+        (*cmp_slot)++;
+        if (!(a->s.row[v >> 6] >> (v & 63) & 1)) return 0;
+        a->s.row[v >> 6] &= ~(1ULL << (v & 63));
+        a->deg--;
+        if (a->deg < g->down_deg) gh_to_array(g, a);
+        return 1;
+    }
+    int pos = gh_lower_bound(a, v, cmp_slot);
+    if (pos == a->deg || a->s.arr[pos] != v) return 0;
+    memmove(a->s.arr + pos, a->s.arr + pos + 1, (size_t)(a->deg - pos - 1) * sizeof(int));
+    a->deg--;
+    return 1;
+}
+
+static void gh_add_edge(GraphHybrid* g, int u, int v, CmpCounter* cc) {
+    if (!gh_has_edge_oneway(g, u, v, &cc->insert_cmp)) {
+        gh_insert_oneway(g, u, v);
+        gh_insert_oneway(g, v, u);
+    }
+}
+
+static void gh_remove_edge(GraphHybrid* g, int u, int v, CmpCounter* cc) {
+    gh_remove_oneway(g, u, v, &cc->delete_cmp);
+    gh_remove_oneway(g, v, u, &cc->delete_cmp);
+}
+
+static int gh_has_edge(GraphHybrid* g, int u, int v, CmpCounter* cc) {
+    return gh_has_edge_oneway(g, u, v, &cc->check_cmp);
+}
+
+static void gh_print_neighbors(GraphHybrid* g, int u, CmpCounter* cc) {
+    const HybridAdj* a = &g->adj[u];
+    if (a->cap >= 0) {
+        for (int i = 0; i < a->deg; ++i) cc->print_cmp++;  // printf("%d ", a->s.arr[i]);
+        return;
+    }
+    for (size_t w = 0; w < g->row_words; ++w) {
+        cc->print_cmp++;              // one zero-test per word
+        for (uint64_t x = a->s.row[w]; x; x &= x - 1) {
+            int j = (int)(w * 64) + bit_ctz64(x);
+            (void)j; // printf("%d ", j);
+        }
+    }
+}
+
+static size_t gh_memory_bytes(GraphHybrid* g) {
+    return sizeof(GraphHybrid) + (size_t)g->n * sizeof(HybridAdj) + g->heap_bytes;
+}
+
+/* ---------- Graph (Dynamic, batched updates) ---------- */
+
+static GraphDyn* gd_create(int n) {
+    GraphDyn* g = (GraphDyn*)malloc(sizeof(GraphDyn));
+    g->n = n;
+    g->adj = (DynAdj*)calloc(n, sizeof(DynAdj));
+    g->slots = g->tombstones = 0;
+    g->compactions = 0;
+    return g;
+}
+
+static void gd_free(GraphDyn* g) {
+    if (!g) return;
+    for (int i = 0; i < g->n; ++i) free(g->adj[i].v);
+    free(g->adj);
+    free(g);
+}
+
+static void dyn_compact(DynAdj* a) {
+    int k = 0;
+    for (int i = 0; i < a->len; ++i)
+        if (a->v[i] >= 0) a->v[k++] = a->v[i];
+    a->len = k;
+}
+
+// First slot at or after `from` whose key is >= v: gallop, then binary search,
+// so a few updates on a long list cost O(log) each instead of O(len)
+static int dyn_seek(const DynAdj* a, int from, int v) {
+    int lo = from, step = 1, hi = from;
+    while (hi < a->len && DYN_KEY(a->v[hi]) < v) { lo = hi + 1; hi += step; step *= 2; }
+    if (hi > a->len) hi = a->len;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (DYN_KEY(a->v[mid]) < v) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// Apply one vertex's updates, sorted by v (batch order kept for equal v, so
+// the last one decides). One forward pass: deletes tombstone in place,
+// inserts revive a tombstone or, when v is new, are collected in `fresh` and
+// merged in from the back afterwards (compacting the list first). The pass
+// costs O(count log(len / count)); the O(len) merge happens only when
+// something new is inserted. Returns the change in
+// slots/tombstones through the out-params (the caller reduces them).
+static void dyn_apply_vertex(DynAdj* a, const EdgeUpdate* ups, int count, int* fresh,
+    long long* d_slots, long long* d_tomb) {
+    int pos = 0, nf = 0;
+    for (int k = 0; k < count; ++k) {
+        if (k + 1 < count && ups[k + 1].v == ups[k].v) continue;
+        int v = ups[k].v;
+        pos = dyn_seek(a, pos, v);
+        int found = pos < a->len && DYN_KEY(a->v[pos]) == v;
+        if (ups[k].op) {
+            if (!found) fresh[nf++] = v;
+            else if (a->v[pos] < 0) { a->v[pos] = v; a->live++; (*d_tomb)--; }
+        }
+        else if (found && a->v[pos] >= 0) {
+            a->v[pos] = DYN_TOMBSTONE(v);
+            a->live--;
+            (*d_tomb)++;
+        }
+    }
+    if (nf == 0) return;
+    if (a->len > a->live) {   // the list is rewritten anyway: drop its tombstones first
+        *d_tomb -= a->len - a->live;
+        *d_slots -= a->len - a->live;
+        dyn_compact(a);
+    }
+    if (a->len + nf > a->cap) {
+        while (a->len + nf > a->cap) a->cap = a->cap ? a->cap * 2 : 4;
+        a->v = (int*)realloc(a->v, (size_t)a->cap * sizeof(int));
+    }
+    for (int i = a->len - 1, j = nf - 1, o = a->len + nf - 1; j >= 0; --o)
+        a->v[o] = i >= 0 && DYN_KEY(a->v[i]) > fresh[j] ? a->v[i--] : fresh[j--];
+    a->len += nf;
+    a->live += nf;
+    *d_slots += nf;
+}
+
+// Stable LSD radix sort of half-updates by source vertex, 8-bit passes,
+// only as many as ids below n need
+static void sort_updates_by_source(EdgeUpdate* a, EdgeUpdate* tmp, size_t k, int n) {
+    for (int shift = 0; shift < 32 && ((uint32_t)(n - 1) >> shift) != 0; shift += 8) {
+        size_t count[257] = { 0 };
+        for (size_t i = 0; i < k; ++i) count[((uint32_t)a[i].u >> shift & 0xff) + 1]++;
+        for (int b = 0; b < 256; ++b) count[b + 1] += count[b];
+        for (size_t i = 0; i < k; ++i) tmp[count[(uint32_t)a[i].u >> shift & 0xff]++] = a[i];
+        memcpy(a, tmp, k * sizeof(EdgeUpdate));
+    }
+}
+
+// Stable sort of one source's group by target: insertion sort for short
+// groups, merge sort through tmp (same length) otherwise
+static void sort_group_by_target(EdgeUpdate* a, EdgeUpdate* tmp, int count) {
+    if (count <= 32) {
+        for (int i = 1; i < count; ++i) {
+            EdgeUpdate x = a[i];
+            int j = i;
+            for (; j > 0 && a[j - 1].v > x.v; --j) a[j] = a[j - 1];
+            a[j] = x;
+        }
+        return;
+    }
+    int h = count / 2;
+    sort_group_by_target(a, tmp, h);
+    sort_group_by_target(a + h, tmp + h, count - h);
+    for (int i = 0, j = h, o = 0; o < count; ++o)
+        tmp[o] = j >= count || (i < h && a[i].v <= a[j].v) ? a[i++] : a[j++];
+    memcpy(a, tmp, (size_t)count * sizeof(EdgeUpdate));
+}
+
+// Drop all tombstones (every vertex in parallel)
+static void gd_compact(GraphDyn* g) {
+    long long slots = 0;
+#pragma omp parallel for schedule(dynamic, 1024) reduction(+:slots)
+    for (int u = 0; u < g->n; ++u) {
+        dyn_compact(&g->adj[u]);
+        slots += g->adj[u].len;
+    }
+    g->slots = slots;
+    g->tombstones = 0;
+    g->compactions++;
+}
+
+// Apply a batch of undirected updates (in order per edge). Each update is
+// split into two half-updates, grouped by source (then sorted by target
+// within the group), and each thread owns whole vertices, so no locks are needed.
+static void gd_apply_batch(GraphDyn* g, const EdgeUpdate* batch, size_t k) {
+    EdgeUpdate* half = (EdgeUpdate*)malloc(2 * k * sizeof(EdgeUpdate) + sizeof(EdgeUpdate));
+    EdgeUpdate* tmp = (EdgeUpdate*)malloc(2 * k * sizeof(EdgeUpdate) + sizeof(EdgeUpdate));
+    size_t* group = (size_t*)malloc((2 * k + 1) * sizeof(size_t));
+    int* fresh = (int*)malloc(2 * k * sizeof(int) + sizeof(int));   // per group: [b, e)
+    size_t groups = 0;
+
+    for (size_t i = 0; i < k; ++i) {
+        half[2 * i] = batch[i];
+        half[2 * i + 1] = (EdgeUpdate){ batch[i].v, batch[i].u, batch[i].op };
+    }
+    sort_updates_by_source(half, tmp, 2 * k, g->n);
+    for (size_t i = 0; i < 2 * k; ++i)
+        if (i == 0 || half[i].u != half[i - 1].u) group[groups++] = i;
+    group[groups] = 2 * k;
+
+    long long d_slots = 0, d_tomb = 0;
+#pragma omp parallel for schedule(dynamic, 64) reduction(+:d_slots, d_tomb)
+    for (long long gi = 0; gi < (long long)groups; ++gi) {
+        size_t b = group[gi], e = group[gi + 1];
+        DynAdj* a = &g->adj[half[b].u];
+        sort_group_by_target(half + b, tmp + b, (int)(e - b));
+        dyn_apply_vertex(a, half + b, (int)(e - b), fresh + b, &d_slots, &d_tomb);
+        if (a->len - a->live > a->live && a->len > 8) { // this list is mostly holes
+            d_tomb -= a->len - a->live;
+            d_slots -= a->len - a->live;
+            dyn_compact(a);
+        }
+    }
+    g->slots += d_slots;
+    g->tombstones += d_tomb;
+    if (g->tombstones > DYN_COMPACT_RATIO * (double)g->slots) gd_compact(g);
+
+    free(half); free(tmp); free(group); free(fresh);
+}
+
+static long long gd_live_half_edges(const GraphDyn* g) {
+    long long s = 0;
+    for (int u = 0; u < g->n; ++u) s += g->adj[u].live;
+    return s;
+}
+
+/* ---------- Build graphs from edge set ---------- */
+
+static GraphMatrix* build_matrix_from_edges(int n, Edge* edges, int E) {
+    GraphMatrix* gm = gm_create(n);
+    CmpCounter tmp = { 0 };
+    for (int i = 0; i < E; ++i) gm_add_edge(gm, edges[i].u, edges[i].v, &tmp);
+    return gm;
+}
+
+static GraphBitMatrix* build_bitmatrix_from_edges(int n, Edge* edges, int E) {
+    GraphBitMatrix* gb = gb_create(n);
+    CmpCounter tmp = { 0 };
+    for (int i = 0; i < E; ++i) gb_add_edge(gb, edges[i].u, edges[i].v, &tmp);
+    return gb;
+}
+
+static GraphList* build_list_from_edges(int n, Edge* edges, int E) {
+    GraphList* gl = gl_create(n);
+    CmpCounter tmp = { 0 };
+    for (int i = 0; i < E; ++i) gl_add_edge(gl, edges[i].u, edges[i].v, &tmp);
+    return gl;
+}
+
+// Counting sort by source: degree pass, prefix sum, scatter. Edges are
+// assumed unique (as produced by generate_random_edge_set).
+static GraphCSR* build_csr_from_edges(int n, Edge* edges, int E, int sort_neighbors) {
+    GraphCSR* g = (GraphCSR*)malloc(sizeof(GraphCSR));
+    g->n = n;
+    g->sorted = sort_neighbors;
+    g->file = NULL;
+    g->offsets = (int64_t*)calloc((size_t)n + 1, sizeof(int64_t));
+    for (int i = 0; i < E; ++i) {
+        g->offsets[edges[i].u + 1]++;
+        g->offsets[edges[i].v + 1]++;
+    }
+    for (int u = 0; u < n; ++u) g->offsets[u + 1] += g->offsets[u];
+    g->nbrs = (int*)malloc((size_t)g->offsets[n] * sizeof(int) + 1);
+    int64_t* cursor = (int64_t*)malloc((size_t)n * sizeof(int64_t));
+    memcpy(cursor, g->offsets, (size_t)n * sizeof(int64_t));
+    for (int i = 0; i < E; ++i) {
+        g->nbrs[cursor[edges[i].u]++] = edges[i].v;
+        g->nbrs[cursor[edges[i].v]++] = edges[i].u;
+    }
+    free(cursor);
+    if (sort_neighbors)
+        for (int u = 0; u < n; ++u)
+            sort_ints(g->nbrs + g->offsets[u], (size_t)(g->offsets[u + 1] - g->offsets[u]));
+    return g;
+}
+
+// In-place exclusive prefix sum of a[0..n) (a[n] receives the total),
+// in T contiguous blocks: block sums, a short serial scan, then block fill
+static void parallel_exclusive_scan(int64_t* a, int n) {
+    int T = max_threads();
+    int64_t* part = (int64_t*)calloc((size_t)T + 1, sizeof(int64_t));
+#pragma omp parallel for schedule(static)
+    for (int t = 0; t < T; ++t) {
+        int b = (int)((long long)n * t / T), e = (int)((long long)n * (t + 1) / T);
+        int64_t sum = 0;
+        for (int i = b; i < e; ++i) sum += a[i];
+        part[t + 1] = sum;
+    }
+    for (int t = 0; t < T; ++t) part[t + 1] += part[t];
+#pragma omp parallel for schedule(static)
+    for (int t = 0; t < T; ++t) {
+        int b = (int)((long long)n * t / T), e = (int)((long long)n * (t + 1) / T);
+        int64_t run = part[t];
+        for (int i = b; i < e; ++i) { int64_t x = a[i]; a[i] = run; run += x; }
+    }
+    a[n] = part[T];
+    free(part);
+}
+
+// Parallel Edge[] -> CSR: degree histogram, prefix sum, scatter, then
+// optional per-list sort + dedup. Self-loops are dropped. When the
+// per-thread tables fit (threads * n counters <= 2E, or one thread), every thread gets its
+// own histogram and scatter offsets (no atomics, deterministic layout);
+// otherwise per-vertex atomic cursors are used.
+static GraphCSR* build_csr_parallel(int n, const Edge* edges, long long E, int sort_dedup) {
+    int T = max_threads();
+    GraphCSR* g = (GraphCSR*)malloc(sizeof(GraphCSR));
+    g->n = n;
+    g->sorted = sort_dedup;
+    g->file = NULL;
+    g->offsets = (int64_t*)calloc((size_t)n + 1, sizeof(int64_t));
+    int per_thread = T == 1 || (long long)T * n <= 2 * E;
+
+    if (per_thread) {
+        // chunk t of the edge array always goes with counter row t
+        int64_t* cnt = (int64_t*)calloc((size_t)T * n, sizeof(int64_t));
+#pragma omp parallel for schedule(static)
+        for (int t = 0; t < T; ++t) {
+            int64_t* mine = cnt + (size_t)t * n;
+            for (long long i = E * t / T; i < E * (t + 1) / T; ++i)
+                if (edges[i].u != edges[i].v) { mine[edges[i].u]++; mine[edges[i].v]++; }
+        }
+#pragma omp parallel for
+        for (int v = 0; v < n; ++v) {
+            int64_t d = 0;
+            for (int k = 0; k < T; ++k) d += cnt[(size_t)k * n + v];
+            g->offsets[v] = d;
+        }
+        parallel_exclusive_scan(g->offsets, n);
+        g->nbrs = (int*)malloc((size_t)g->offsets[n] * sizeof(int) + sizeof(int));
+        // chunk k writes vertex v's entries right after chunks 0..k-1
+#pragma omp parallel for
+        for (int v = 0; v < n; ++v) {
+            int64_t run = g->offsets[v];
+            for (int k = 0; k < T; ++k) {
+                int64_t c = cnt[(size_t)k * n + v];
+                cnt[(size_t)k * n + v] = run;
+                run += c;
+            }
+        }
+#pragma omp parallel for schedule(static)
+        for (int t = 0; t < T; ++t) {
+            int64_t* mine = cnt + (size_t)t * n;
+            for (long long i = E * t / T; i < E * (t + 1) / T; ++i) {
+                if (edges[i].u == edges[i].v) continue;
+                g->nbrs[mine[edges[i].u]++] = edges[i].v;
+                g->nbrs[mine[edges[i].v]++] = edges[i].u;
+            }
+        }
+        free(cnt);
+    }
+    else {
+#pragma omp parallel for
+        for (long long i = 0; i < E; ++i) {
+            if (edges[i].u == edges[i].v) continue;
+#pragma omp atomic
+            g->offsets[edges[i].u]++;
+#pragma omp atomic
+            g->offsets[edges[i].v]++;
+        }
+        parallel_exclusive_scan(g->offsets, n);
+        g->nbrs = (int*)malloc((size_t)g->offsets[n] * sizeof(int) + sizeof(int));
+        int64_t* cursor = (int64_t*)malloc((size_t)n * sizeof(int64_t) + sizeof(int64_t));
+        memcpy(cursor, g->offsets, (size_t)n * sizeof(int64_t));
+#pragma omp parallel for
+        for (long long i = 0; i < E; ++i) {
+            int u = edges[i].u, v = edges[i].v;
+            int64_t pu, pv;
+            if (u == v) continue;
+#pragma omp atomic capture
+            pu = cursor[u]++;
+#pragma omp atomic capture
+            pv = cursor[v]++;
+            g->nbrs[pu] = v;
+            g->nbrs[pv] = u;
+        }
+        free(cursor);
+    }
+
+    if (sort_dedup) {
+        // sort + unique each list in place, then squeeze out the gaps
+        int64_t* deg = (int64_t*)malloc(((size_t)n + 1) * sizeof(int64_t));
+#pragma omp parallel for schedule(dynamic, 256)
+        for (int u = 0; u < n; ++u) {
+            int* l = g->nbrs + g->offsets[u];
+            int64_t d = g->offsets[u + 1] - g->offsets[u], k = 0;
+            sort_ints(l, (size_t)d);
+            for (int64_t i = 0; i < d; ++i)
+                if (k == 0 || l[i] != l[k - 1]) l[k++] = l[i];
+            deg[u] = k;
+        }
+        parallel_exclusive_scan(deg, n);
+        int* packed = (int*)malloc((size_t)deg[n] * sizeof(int) + sizeof(int));
+#pragma omp parallel for schedule(dynamic, 256)
+        for (int u = 0; u < n; ++u)
+            memcpy(packed + deg[u], g->nbrs + g->offsets[u], (size_t)(deg[u + 1] - deg[u]) * sizeof(int));
+        free(g->nbrs);
+        free(g->offsets);
+        g->nbrs = packed;
+        g->offsets = deg;
+    }
+    return g;
+}
+
+// Encode a CSR: per-list sizes, scan, encode. gz_has_edge stops at the first
+// neighbor >= v, so unsorted input is encoded from a sorted copy.
+static GraphCompressed* build_compressed_from_csr(const GraphCSR* c) {
+    int n = c->n, max_deg = 0;
+    GraphCompressed* g = (GraphCompressed*)malloc(sizeof(GraphCompressed));
+    const int* nbrs = c->nbrs;
+    int* sorted_copy = NULL;
+    svb_init();
+    if (!c->sorted) {
+        sorted_copy = (int*)malloc(((size_t)c->offsets[n] + 1) * sizeof(int));
+        memcpy(sorted_copy, c->nbrs, (size_t)c->offsets[n] * sizeof(int));
+#pragma omp parallel for schedule(dynamic, 1024)
+        for (int u = 0; u < n; ++u)
+            sort_ints(sorted_copy + c->offsets[u], (size_t)(c->offsets[u + 1] - c->offsets[u]));
+        nbrs = sorted_copy;
+    }
+    g->n = n;
+    g->half_edges = c->offsets[n];
+    g->offsets = (int64_t*)malloc(((size_t)n + 1) * sizeof(int64_t));
+#pragma omp parallel for schedule(dynamic, 1024) reduction(max:max_deg)
+    for (int u = 0; u < n; ++u) {
+        int deg = (int)(c->offsets[u + 1] - c->offsets[u]);
+        g->offsets[u] = (int64_t)gz_list_bytes(u, nbrs + c->offsets[u], deg);
+        if (deg > max_deg) max_deg = deg;
+    }
+    parallel_exclusive_scan(g->offsets, n);
+    g->max_degree = max_deg;
+    g->data = (uint8_t*)malloc((size_t)g->offsets[n] + 16);
+    memset(g->data + g->offsets[n], 0, 16);
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int u = 0; u < n; ++u)
+        gz_encode_list(u, nbrs + c->offsets[u], (int)(c->offsets[u + 1] - c->offsets[u]),
+            g->data + g->offsets[u]);
+    free(sorted_copy);
+    return g;
+}
+
+static GraphHashSet* build_hashset_from_edges(int n, Edge* edges, int E) {
+    GraphHashSet* g = gs_create(n);
+    CmpCounter tmp = { 0 };
+    for (int i = 0; i < E; ++i) gs_add_edge(g, edges[i].u, edges[i].v, &tmp);
+    return g;
+}
+
+static GraphHybrid* build_hybrid_from_edges(int n, Edge* edges, int E) {
+    GraphHybrid* g = gh_create(n);
+    CmpCounter tmp = { 0 };
+    for (int i = 0; i < E; ++i) gh_add_edge(g, edges[i].u, edges[i].v, &tmp);
+    return g;
+}
+
+/* ---------- Vertex reordering ---------- */
+
+// Each ordering fills new_to_old[0..n); gc_permute then relabels the graph.
+// Ties are broken by old ID so every ordering is deterministic.
+
+static int csr_degree(const GraphCSR* g, int u) { return (int)(g->offsets[u + 1] - g->offsets[u]); }
+
+// Vertices by degree via counting sort; descending puts hubs first
+static void order_by_degree(const GraphCSR* g, int* new_to_old, int descending) {
+    int n = g->n, max_deg = 0;
+    for (int u = 0; u < n; ++u)
+        if (csr_degree(g, u) > max_deg) max_deg = csr_degree(g, u);
+    int64_t* start = (int64_t*)calloc((size_t)max_deg + 2, sizeof(int64_t));
+    for (int u = 0; u < n; ++u) {
+        int d = csr_degree(g, u);
+        start[(descending ? max_deg - d : d) + 1]++;
+    }
+    for (int d = 0; d <= max_deg; ++d) start[d + 1] += start[d];
+    for (int u = 0; u < n; ++u) {
+        int d = csr_degree(g, u);
+        new_to_old[start[descending ? max_deg - d : d]++] = u;
+    }
+    free(start);
+}
+
+// BFS discovery order; each new component starts at its lowest old ID
+static void order_bfs(const GraphCSR* g, int* new_to_old) {
+    int n = g->n, tail = 0;
+    uint8_t* seen = (uint8_t*)calloc((size_t)n + 1, 1);
+    for (int s = 0; s < n; ++s) {
+        if (seen[s]) continue;
+        int head = tail;
+        seen[s] = 1;
+        new_to_old[tail++] = s;
+        while (head < tail) {
+            int u = new_to_old[head++];
+            for (int64_t i = g->offsets[u]; i < g->offsets[u + 1]; ++i)
+                if (!seen[g->nbrs[i]]) { seen[g->nbrs[i]] = 1; new_to_old[tail++] = g->nbrs[i]; }
+        }
+    }
+    free(seen);
+}
+
+static int cmp_u64_asc(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// BFS from s over the vertices with mark[v] == 0, writing them to order[];
+// returns the count and the index where the last BFS level starts.
+// Neighbors are enqueued by ascending degree when by_degree is set
+// (Cuthill-McKee); keys is scratch for max-degree entries.
+static int bfs_order_from(const GraphCSR* g, int s, uint8_t* mark, int* order, int by_degree,
+    uint64_t* keys, int* last_level) {
+    int head = 0, tail = 0, level_end = 1;
+    mark[s] = 1;
+    order[tail++] = s;
+    *last_level = 0;
+    while (head < tail) {
+        if (head == level_end) { *last_level = head; level_end = tail; }
+        int u = order[head++], k = 0;
+        for (int64_t i = g->offsets[u]; i < g->offsets[u + 1]; ++i) {
+            int v = g->nbrs[i];
+            if (mark[v]) continue;
+            mark[v] = 1;
+            if (by_degree) keys[k++] = (uint64_t)csr_degree(g, v) << 32 | (uint32_t)v;
+            else order[tail++] = v;
+        }
+        if (k > 1) qsort(keys, (size_t)k, sizeof(uint64_t), cmp_u64_asc);
+        for (int j = 0; j < k; ++j) order[tail++] = (int)(uint32_t)keys[j];
+    }
+    return tail;
+}
+
+// Reverse Cuthill-McKee. Each component starts from a pseudo-peripheral
+// vertex: its lowest-degree vertex, moved once to the lowest-degree vertex
+// of the farthest BFS level (one George-Liu step).
+static void order_rcm(const GraphCSR* g, int* new_to_old) {
+    int n = g->n, placed = 0, max_deg = 0, last;
+    uint8_t* mark = (uint8_t*)calloc((size_t)n + 1, 1);
+    int* by_deg = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    for (int u = 0; u < n; ++u)
+        if (csr_degree(g, u) > max_deg) max_deg = csr_degree(g, u);
+    uint64_t* keys = (uint64_t*)malloc(((size_t)max_deg + 1) * sizeof(uint64_t));
+    order_by_degree(g, by_deg, 0);
+
+    for (int i = 0; i < n; ++i) {
+        int s = by_deg[i];
+        if (mark[s]) continue;
+        // probe BFS (output overwritten below), then unmark the component
+        int* comp = new_to_old + placed;
+        int size = bfs_order_from(g, s, mark, comp, 0, keys, &last);
+        s = comp[last];
+        for (int j = last + 1; j < size; ++j)
+            if (csr_degree(g, comp[j]) < csr_degree(g, s)) s = comp[j];
+        for (int j = 0; j < size; ++j) mark[comp[j]] = 0;
+        placed += bfs_order_from(g, s, mark, comp, 1, keys, &last);
+    }
+    for (int i = 0, j = n - 1; i < j; ++i, --j) {
+        int t = new_to_old[i];
+        new_to_old[i] = new_to_old[j];
+        new_to_old[j] = t;
+    }
+    free(keys);
+    free(by_deg);
+    free(mark);
+}
+
+// Relabel: new vertex i is old vertex new_to_old[i]. Lists come out sorted.
+// old_to_new (size n) receives the inverse mapping when non-NULL.
+static GraphCSR* gc_permute(const GraphCSR* g, const int* new_to_old, int* old_to_new) {
+    int n = g->n;
+    int* inv = old_to_new ? old_to_new : (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    GraphCSR* r = (GraphCSR*)malloc(sizeof(GraphCSR));
+    r->n = n;
+    r->sorted = 1;
+    r->file = NULL;
+    r->offsets = (int64_t*)malloc(((size_t)n + 1) * sizeof(int64_t));
+#pragma omp parallel for
+    for (int i = 0; i < n; ++i) {
+        inv[new_to_old[i]] = i;
+        r->offsets[i] = csr_degree(g, new_to_old[i]);
+    }
+    parallel_exclusive_scan(r->offsets, n);
+    r->nbrs = (int*)malloc((size_t)r->offsets[n] * sizeof(int) + sizeof(int));
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int i = 0; i < n; ++i) {
+        int old = new_to_old[i];
+        int* out = r->nbrs + r->offsets[i];
+        int d = csr_degree(g, old);
+        for (int k = 0; k < d; ++k) out[k] = inv[g->nbrs[g->offsets[old] + k]];
+        sort_ints(out, (size_t)d);
+    }
+    if (!old_to_new) free(inv);
+    return r;
+}
+
+// Plain queue BFS on CSR; dist[v] = hops from s or -1. Returns vertices reached.
+static int gc_bfs(const GraphCSR* g, int s, int* dist, int* queue) {
+    int head = 0, tail = 0;
+    for (int v = 0; v < g->n; ++v) dist[v] = -1;
+    dist[s] = 0;
+    queue[tail++] = s;
+    while (head < tail) {
+        int u = queue[head++];
+        for (int64_t i = g->offsets[u]; i < g->offsets[u + 1]; ++i) {
+            int v = g->nbrs[i];
+            if (dist[v] < 0) { dist[v] = dist[u] + 1; queue[tail++] = v; }
+        }
+    }
+    return tail;
+}
+
+/* ---------- Sorted-set intersection ---------- */
+
+// All kernels count |a ∩ b| for ascending, duplicate-free int arrays
+typedef long long (*IntersectFn)(const int* a, int64_t na, const int* b, int64_t nb);
+
+static long long intersect_merge(const int* a, int64_t na, const int* b, int64_t nb) {
+    int64_t i = 0, j = 0;
+    long long c = 0;
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) ++i;
+        else if (a[i] > b[j]) ++j;
+        else { ++c; ++i; ++j; }
+    }
+    return c;
+}
+
+// Each element of the shorter list is found in the longer one by doubling
+// steps from the last match, then binary search: O(ns log(nl / ns))
+static long long intersect_gallop(const int* a, int64_t na, const int* b, int64_t nb) {
+    if (na > nb) { const int* t = a; a = b; b = t; int64_t tn = na; na = nb; nb = tn; }
+    int64_t lo = 0;
+    long long c = 0;
+    for (int64_t i = 0; i < na && lo < nb; ++i) {
+        int x = a[i];
+        int64_t step = 1, hi = lo;
+        while (hi < nb && b[hi] < x) { lo = hi + 1; hi += step; step <<= 1; }
+        if (hi > nb) hi = nb;
+        while (lo < hi) {
+            int64_t mid = lo + (hi - lo) / 2;
+            if (b[mid] < x) lo = mid + 1;
+            else hi = mid;
+        }
+        if (lo < nb && b[lo] == x) { ++c; ++lo; }
+    }
+    return c;
+}
+
+// 4x4 block compare: a block is checked against all four rotations of the
+// b block, then whichever block has the smaller maximum advances
+static long long intersect_simd(const int* a, int64_t na, const int* b, int64_t nb) {
+    int64_t i = 0, j = 0;
+    long long c = 0;
+#ifdef __SSE2__
+    while (i + 4 <= na && j + 4 <= nb) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + j));
+        __m128i m = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi32(va, vb),
+                _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+            _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+                _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+        c += bit_popcount64((uint64_t)_mm_movemask_ps(_mm_castsi128_ps(m)));
+        int amax = a[i + 3], bmax = b[j + 3];
+        if (amax <= bmax) i += 4;
+        if (bmax <= amax) j += 4;
+    }
+#endif
+    return c + intersect_merge(a + i, na - i, b + j, nb - j);
+}
+
+// Galloping once one side is much longer, block compare otherwise
+static long long intersect_adaptive(const int* a, int64_t na, const int* b, int64_t nb) {
+    if (na * 32 < nb || nb * 32 < na) return intersect_gallop(a, na, b, nb);
+    return intersect_simd(a, na, b, nb);
+}
+
+// Forward (oriented) graph for triangle counting: keep u -> v only when v
+// ranks higher by (degree, id). Each triangle is then counted exactly once
+// and every list has O(sqrt(E)) entries. Lists stay sorted by ID.
+static GraphCSR* build_forward_csr(const GraphCSR* g) {
+    int n = g->n;
+    GraphCSR* f = (GraphCSR*)malloc(sizeof(GraphCSR));
+    f->n = n;
+    f->sorted = 1;
+    f->file = NULL;
+    f->offsets = (int64_t*)malloc(((size_t)n + 1) * sizeof(int64_t));
+#define FWD_RANKS_HIGHER(u, v) (csr_degree(g, v) > csr_degree(g, u) \
+    || (csr_degree(g, v) == csr_degree(g, u) && (v) > (u)))
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int u = 0; u < n; ++u) {
+        int64_t k = 0;
+        for (int64_t i = g->offsets[u]; i < g->offsets[u + 1]; ++i)
+            if (FWD_RANKS_HIGHER(u, g->nbrs[i])) ++k;
+        f->offsets[u] = k;
+    }
+    parallel_exclusive_scan(f->offsets, n);
+    f->nbrs = (int*)malloc((size_t)f->offsets[n] * sizeof(int) + sizeof(int));
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int u = 0; u < n; ++u) {
+        int64_t k = f->offsets[u];
+        for (int64_t i = g->offsets[u]; i < g->offsets[u + 1]; ++i)
+            if (FWD_RANKS_HIGHER(u, g->nbrs[i])) f->nbrs[k++] = g->nbrs[i];
+    }
+#undef FWD_RANKS_HIGHER
+    return f;
+}
+
+// Triangles of the (undirected, sorted) graph behind forward CSR f
+static long long count_triangles(const GraphCSR* f, IntersectFn isect) {
+    long long tri = 0;
+#pragma omp parallel for schedule(dynamic, 256) reduction(+:tri)
+    for (int u = 0; u < f->n; ++u) {
+        const int* nu = f->nbrs + f->offsets[u];
+        int64_t du = f->offsets[u + 1] - f->offsets[u];
+        for (int64_t i = 0; i < du; ++i) {
+            int v = nu[i];
+            tri += isect(nu, du, f->nbrs + f->offsets[v], f->offsets[v + 1] - f->offsets[v]);
+        }
+    }
+    return tri;
+}
+
+// Common-neighbor counts for q (u, v) pairs, answered in parallel
+static long long common_neighbors_batch(const GraphCSR* g, const Edge* pairs, int q,
+    IntersectFn isect, int* out) {
+    long long total = 0;
+#pragma omp parallel for schedule(dynamic, 256) reduction(+:total)
+    for (int i = 0; i < q; ++i) {
+        int u = pairs[i].u, v = pairs[i].v;
+        out[i] = (int)isect(g->nbrs + g->offsets[u], csr_degree(g, u), g->nbrs + g->offsets[v], csr_degree(g, v));
+        total += out[i];
+    }
+    return total;
+}
+
+/* ---------- Neighbor-scan throughput ---------- */
+
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Each scan visits every vertex's neighbors once and returns a checksum
+// (so the loop cannot be optimized away).
+typedef long long (*ScanFn)(const void* g);
+
+static long long scan_matrix(const void* p) {
+    const GraphMatrix* g = (const GraphMatrix*)p;
+    long long sum = 0;
+    for (int u = 0; u < g->n; ++u)
+        for (int j = 0; j < g->n; ++j)
+            if (g->adj[(size_t)u * g->n + j]) sum += j;
+    return sum;
+}
+
+static long long scan_bitmatrix(const void* p) {
+    const GraphBitMatrix* g = (const GraphBitMatrix*)p;
+    size_t words = ((size_t)g->n + 63) / 64;
+    long long sum = 0;
+    for (int u = 0; u < g->n; ++u) {
+        const uint64_t* row = gb_row(g, u);
+        for (size_t w = 0; w < words; ++w)
+            for (uint64_t x = row[w]; x; x &= x - 1) sum += (long long)(w * 64) + bit_ctz64(x);
+    }
+    return sum;
+}
+
+static long long scan_list(const void* p) {
+    const GraphList* g = (const GraphList*)p;
+    long long sum = 0;
+    for (int u = 0; u < g->n; ++u)
+        for (const Node* cur = g->head[u]; cur; cur = cur->next) sum += cur->v;
+    return sum;
+}
+
+static long long scan_hashset(const void* p) {
+    const GraphHashSet* g = (const GraphHashSet*)p;
+    long long sum = 0;
+    for (int u = 0; u < g->n; ++u) {
+        const AdjSet* a = &g->adj[u];
+        if (a->cap == 0) for (int i = 0; i < a->deg; ++i) sum += a->s.inl[i];
+        else for (int i = 0; i < a->cap; ++i) if (a->s.table[i] != -1) sum += a->s.table[i];
+    }
+    return sum;
+}
+
+static long long scan_hybrid(const void* p) {
+    const GraphHybrid* g = (const GraphHybrid*)p;
+    long long sum = 0;
+    for (int u = 0; u < g->n; ++u) {
+        const HybridAdj* a = &g->adj[u];
+        if (a->cap >= 0) for (int i = 0; i < a->deg; ++i) sum += a->s.arr[i];
+        else
+            for (size_t w = 0; w < g->row_words; ++w)
+                for (uint64_t x = a->s.row[w]; x; x &= x - 1) sum += (long long)(w * 64) + bit_ctz64(x);
+    }
+    return sum;
+}
+
+static long long scan_csr(const void* p) {
+    const GraphCSR* g = (const GraphCSR*)p;
+    long long sum = 0;
+    for (int64_t i = 0; i < g->offsets[g->n]; ++i) sum += g->nbrs[i];
+    return sum;
+}
+
+static long long scan_compressed(const void* p) {
+    const GraphCompressed* g = (const GraphCompressed*)p;
+    long long sum = 0;
+    GzIter it;
+    int v;
+    for (int u = 0; u < g->n; ++u) {
+        gz_iter_begin(g, u, &it);
+        while (gz_iter_next(&it, &v)) sum += v;
+    }
+    return sum;
+}
+
+// Bulk decode into caller-owned scratch (max_degree + 4 ints), so the scan
+// keeps no state of its own and separate callers can run it concurrently
+typedef struct {
+    const GraphCompressed* g;
+    int* buf;
+} GzBulkScan;
+
+static long long scan_compressed_bulk(const void* p) {
+    const GzBulkScan* bs = (const GzBulkScan*)p;
+    const GraphCompressed* g = bs->g;
+    long long sum = 0;
+    for (int u = 0; u < g->n; ++u) {
+        int deg = gz_decode_list(g, u, bs->buf);
+        for (int i = 0; i < deg; ++i) sum += bs->buf[i];
+    }
+    return sum;
+}
+
+// Neighbor gather x[v] over every list (the access pattern of SpMV /
+// PageRank), so it is sensitive to how close neighbor IDs are
+typedef struct {
+    const GraphCSR* g;
+    const int* x;
+} GatherScan;
+
+static long long scan_csr_gather(const void* p) {
+    const GatherScan* gs = (const GatherScan*)p;
+    const GraphCSR* g = gs->g;
+    long long sum = 0;
+    for (int64_t i = 0; i < g->offsets[g->n]; ++i) sum += gs->x[g->nbrs[i]];
+    return sum;
+}
+
+// Repeat full scans for at least ~50 ms; returns neighbors delivered per second
+static double measure_scan_throughput(ScanFn scan, const void* g, size_t half_edges) {
+    volatile long long sink = 0;
+    long long reps = 0;
+    double t0 = now_seconds(), dt;
+    do {
+        sink += scan(g);
+        reps++;
+        dt = now_seconds() - t0;
+    } while (dt < 0.05);
+    (void)sink;
+    return dt > 0 ? (double)half_edges * reps / dt : 0.0;
+}
+
+/* ---------- Experiment runners ---------- */
+
+static void make_random_pair(int n, int* u, int* v) {
+    do {
+        *u = rand() % n;
+        *v = rand() % n;
+    } while (*u == *v);
+    if (*u > *v) { int t = *u; *u = *v; *v = t; }
+}
+
+static void run_case_matrix(const char* title, int n, Edge* base_edges, int E) {
+    GraphMatrix* g = build_matrix_from_edges(n, base_edges, E);
+    CmpCounter cc = { 0 };
+
+    // 1) Memory
+    size_t mem = gm_memory_bytes(g);
+
+    // 2) Insert/Delete comparisons: do T trials with non-existing random edges (insert then delete)
+    const int Tio = 100;
+    for (int t = 0; t < Tio; ++t) {
+        int u, v;
+        // find a non-edge to insert (limit attempts)
+        for (int tries = 0; tries < 10000; ++tries) {
+            make_random_pair(n, &u, &v);
+            CmpCounter tmp = { 0 };
+            if (!gm_has_edge(g, u, v, &tmp)) { // count check comps in cc.insert_cmp? keep separate: not required
+                // add then remove (measure comparisons inside add/remove)
+                gm_add_edge(g, u, v, &cc);
+                gm_remove_edge(g, u, v, &cc);
+                break;
+            }
+        }
+    }
+
+    // 3) Connectivity check comparisons: random pairs
+    const int Tc = 100;
+    for (int t = 0; t < Tc; ++t) {
+        int u, v; make_random_pair(n, &u, &v);
+        gm_has_edge(g, u, v, &cc);
+    }
+
+    // 4) Print neighbors comparisons: random nodes
+    const int Tp = 10;
+    for (int t = 0; t < Tp; ++t) {
+        int u = rand() % n;
+        gm_print_neighbors(g, u, &cc);
+    }
+
+    // 5) Neighbor-scan throughput over the whole graph
+    double scan_rate = measure_scan_throughput(scan_matrix, g, (size_t)E * 2);
+
+    printf("%s\n", title);
+    printf("Memory: %zu Bytes\n", mem);
+    printf("Edge insert/delete comparisons (total over %d ops): %llu\n", Tio * 2, cc.insert_cmp + cc.delete_cmp);
+    printf("Connectivity checks (total over %d ops): %llu\n", Tc, cc.check_cmp);
+    printf("Print neighbors comparisons (total over %d ops): %llu\n", Tp, cc.print_cmp);
+    printf("Neighbor scan throughput: %.1f M neighbors/s\n", scan_rate / 1e6);
+    printf("\n");
+
+    gm_free(g);
+}
+
+static void run_case_bitmatrix(const char* title, int n, Edge* base_edges, int E) {
+    GraphBitMatrix* g = build_bitmatrix_from_edges(n, base_edges, E);
+    CmpCounter cc = { 0 };
+
+    // 1) Memory
+    size_t mem = gb_memory_bytes(g);
+
+    // 2) Insert/Delete comparisons on non-edges
+    const int Tio = 100;
+    for (int t = 0; t < Tio; ++t) {
+        int u, v;
+        for (int tries = 0; tries < 10000; ++tries) {
+            make_random_pair(n, &u, &v);
+            CmpCounter tmp = { 0 };
+            if (!gb_has_edge(g, u, v, &tmp)) {
+                gb_add_edge(g, u, v, &cc);
+                gb_remove_edge(g, u, v, &cc);
+                break;
+            }
+        }
+    }
+
+    // 3) Connectivity check comparisons
+    const int Tc = 100;
+    for (int t = 0; t < Tc; ++t) {
+        int u, v; make_random_pair(n, &u, &v);
+        gb_has_edge(g, u, v, &cc);
+    }
+
+    // 4) Print neighbors comparisons (word tests)
+    const int Tp = 10;
+    for (int t = 0; t < Tp; ++t) {
+        int u = rand() % n;
+        gb_print_neighbors(g, u, &cc);
+    }
+
+    // 5) Degrees by popcount must add up to 2E
+    long long deg_sum = 0;
+    for (int u = 0; u < n; ++u) deg_sum += gb_degree(g, u);
+
+    // 6) Row-wise AND/OR on random pairs: |N(u) & N(v)| and |N(u) | N(v)|
+    uint64_t* scratch = (uint64_t*)aligned_calloc64(g->words_per_row * sizeof(uint64_t));
+    long long common = 0, uni = 0;
+    for (int t = 0; t < Tc; ++t) {
+        int u, v; make_random_pair(n, &u, &v);
+        common += gb_common_neighbors(g, u, v, scratch);
+        gb_row_or(scratch, gb_row(g, u), gb_row(g, v), g->words_per_row);
+        for (size_t w = 0; w < g->words_per_row; ++w) uni += bit_popcount64(scratch[w]);
+    }
+    aligned_free64(scratch);
+
+    // 7) Neighbor-scan throughput
+    double scan_rate = measure_scan_throughput(scan_bitmatrix, g, (size_t)E * 2);
+
+    printf("%s\n", title);
+    printf("Memory: %zu Bytes\n", mem);
+    printf("Edge insert/delete comparisons (total over %d ops): %llu\n", Tio * 2, cc.insert_cmp + cc.delete_cmp);
+    printf("Connectivity checks (total over %d ops): %llu\n", Tc, cc.check_cmp);
+    printf("Print neighbors comparisons (total over %d ops): %llu\n", Tp, cc.print_cmp);
+    printf("Popcount degree sum: %lld (2E = %d)\n", deg_sum, 2 * E);
+    printf("Row AND/OR (%d pairs, %zu words each): avg common %.2f, avg union %.2f\n",
+        Tc, g->words_per_row, (double)common / Tc, (double)uni / Tc);
+    printf("Neighbor scan throughput: %.1f M neighbors/s\n", scan_rate / 1e6);
+    printf("\n");
+
+    gb_free(g);
+}
+
+static void run_case_list(const char* title, int n, Edge* base_edges, int E) {
+    GraphList* g = build_list_from_edges(n, base_edges, E);
+    CmpCounter cc = { 0 };
+
+    // 1) Memory
+    size_t mem = gl_memory_bytes(g);
+
+    // 2) Insert/Delete comparisons: do T trials with non-existing edges
+    const int Tio = 100;
+    for (int t = 0; t < Tio; ++t) {
+        int u, v;
+        // choose a non-edge to insert, ensure uniqueness
+        for (int tries = 0; tries < 10000; ++tries) {
+            make_random_pair(g->n, &u, &v);
+            CmpCounter tmp = { 0 };
+            if (!gl_has_edge(g, u, v, &tmp)) {
+                gl_add_edge(g, u, v, &cc);
+                gl_remove_edge(g, u, v, &cc);
+                break;
+            }
+        }
+    }
+
+    // 3) Connectivity check comparisons
+    const int Tc = 100;
+    for (int t = 0; t < Tc; ++t) {
+        int u, v; make_random_pair(g->n, &u, &v);
+        gl_has_edge(g, u, v, &cc);
+    }
+
+    // 4) Print neighbors comparisons
+    const int Tp = 10;
+    for (int t = 0; t < Tp; ++t) {
+        int u = rand() % g->n;
+        gl_print_neighbors(g, u, &cc);
+    }
+
+    // 5) Neighbor-scan throughput
+    double scan_rate = measure_scan_throughput(scan_list, g, g->node_count);
+
+    printf("%s\n", title);
+    printf("Memory: %zu Bytes\n", mem);
+    printf("Edge insert/delete comparisons (total over %d ops): %llu\n", Tio * 2, cc.insert_cmp + cc.delete_cmp);
+    printf("Connectivity checks (total over %d ops): %llu\n", Tc, cc.check_cmp);
+    printf("Print neighbors comparisons (total over %d ops): %llu\n", Tp, cc.print_cmp);
+    printf("Neighbor scan throughput: %.1f M neighbors/s\n", scan_rate / 1e6);
+    printf("\n");
+
+    gl_free(g);
+}
+
+static void run_case_hashset(const char* title, int n, Edge* base_edges, int E) {
+    GraphHashSet* g = build_hashset_from_edges(n, base_edges, E);
+    CmpCounter cc = { 0 };
+
+    // 1) Memory
+    size_t mem = gs_memory_bytes(g);
+
+    // 2) Insert/Delete comparisons on non-edges
+    const int Tio = 100;
+    for (int t = 0; t < Tio; ++t) {
+        int u, v;
+        for (int tries = 0; tries < 10000; ++tries) {
+            make_random_pair(n, &u, &v);
+            CmpCounter tmp = { 0 };
+            if (!gs_has_edge(g, u, v, &tmp)) {
+                gs_add_edge(g, u, v, &cc);
+                gs_remove_edge(g, u, v, &cc);
+                break;
+            }
+        }
+    }
+
+    // 3) Connectivity check comparisons
+    const int Tc = 100;
+    for (int t = 0; t < Tc; ++t) {
+        int u, v; make_random_pair(n, &u, &v);
+        gs_has_edge(g, u, v, &cc);
+    }
+
+    // 4) Print neighbors comparisons
+    const int Tp = 10;
+    for (int t = 0; t < Tp; ++t) {
+        int u = rand() % n;
+        gs_print_neighbors(g, u, &cc);
+    }
+
+    // 5) Neighbor-scan throughput
+    double scan_rate = measure_scan_throughput(scan_hashset, g, (size_t)E * 2);
+
+    int promoted = 0;
+    for (int u = 0; u < n; ++u) promoted += g->adj[u].cap != 0;
+
+    printf("%s\n", title);
+    printf("Memory: %zu Bytes (%d of %d vertices use a hash table)\n", mem, promoted, n);
+    printf("Edge insert/delete comparisons (total over %d ops): %llu (insert %llu, delete %llu)\n",
+        Tio * 2, cc.insert_cmp + cc.delete_cmp, cc.insert_cmp, cc.delete_cmp);
+    printf("Connectivity checks (total over %d ops): %llu\n", Tc, cc.check_cmp);
+    printf("Print neighbors comparisons (total over %d ops): %llu\n", Tp, cc.print_cmp);
+    printf("Neighbor scan throughput: %.1f M neighbors/s\n", scan_rate / 1e6);
+    printf("\n");
+
+    gs_free(g);
+}
+
+static void run_case_hybrid(const char* title, int n, Edge* base_edges, int E) {
+    GraphHybrid* g = build_hybrid_from_edges(n, base_edges, E);
+    CmpCounter cc = { 0 };
+
+    // 1) Memory
+    size_t mem = gh_memory_bytes(g);
+
+    // 2) Insert/Delete comparisons on non-edges
+    const int Tio = 100;
+    for (int t = 0; t < Tio; ++t) {
+        int u, v;
+        for (int tries = 0; tries < 10000; ++tries) {
+            make_random_pair(n, &u, &v);
+            CmpCounter tmp = { 0 };
+            if (!gh_has_edge(g, u, v, &tmp)) {
+                gh_add_edge(g, u, v, &cc);
+                gh_remove_edge(g, u, v, &cc);
+                break;
+            }
+        }
+    }
+
+    // 3) Connectivity check comparisons
+    const int Tc = 100;
+    for (int t = 0; t < Tc; ++t) {
+        int u, v; make_random_pair(n, &u, &v);
+        gh_has_edge(g, u, v, &cc);
+    }
+
+    // 4) Print neighbors comparisons
+    const int Tp = 10;
+    for (int t = 0; t < Tp; ++t) {
+        int u = rand() % n;
+        gh_print_neighbors(g, u, &cc);
+    }
+
+    // 5) Neighbor-scan throughput
+    double scan_rate = measure_scan_throughput(scan_hybrid, g, (size_t)E * 2);
+
+    printf("%s\n", title);
+    printf("Memory: %zu Bytes (%d of %d vertices stored as bitset rows)\n", mem, g->rows, n);
+    printf("Edge insert/delete comparisons (total over %d ops): %llu\n", Tio * 2, cc.insert_cmp + cc.delete_cmp);
+    printf("Connectivity checks (total over %d ops): %llu\n", Tc, cc.check_cmp);
+    printf("Print neighbors comparisons (total over %d ops): %llu\n", Tp, cc.print_cmp);
+    printf("Neighbor scan throughput: %.1f M neighbors/s\n", scan_rate / 1e6);
+    printf("\n");
+
+    gh_free(g);
+}
+
+static void run_case_csr(const char* title, int n, Edge* base_edges, int E) {
+    GraphCSR* g = build_csr_from_edges(n, base_edges, E, 1);
+    CmpCounter cc = { 0 };
+
+    // 1) Memory
+    size_t mem = gc_memory_bytes(g);
+
+    // 2) Insert/Delete: CSR is immutable (rebuild from the edge set instead)
+
+    // 3) Connectivity check comparisons (binary search in sorted lists)
+    const int Tc = 100;
+    for (int t = 0; t < Tc; ++t) {
+        int u, v; make_random_pair(n, &u, &v);
+        gc_has_edge(g, u, v, &cc);
+    }
+
+    // 4) Print neighbors comparisons
+    const int Tp = 10;
+    for (int t = 0; t < Tp; ++t) {
+        int u = rand() % n;
+        gc_print_neighbors(g, u, &cc);
+    }
+
+    // 5) Neighbor-scan throughput
+    double scan_rate = measure_scan_throughput(scan_csr, g, (size_t)g->offsets[n]);
+
+    printf("%s\n", title);
+    printf("Memory: %zu Bytes\n", mem);
+    printf("Edge insert/delete comparisons: n/a (static CSR, rebuilt from edges)\n");
+    printf("Connectivity checks (total over %d ops): %llu\n", Tc, cc.check_cmp);
+    printf("Print neighbors comparisons (total over %d ops): %llu\n", Tp, cc.print_cmp);
+    printf("Neighbor scan throughput: %.1f M neighbors/s\n", scan_rate / 1e6);
+    printf("\n");
+
+    gc_free(g);
+}
+
+// Sample a large G(n, m) and build its CSR, reporting time and memory;
+// with out_path the (sorted) CSR is also written as a graph file
+static void run_sample_benchmark(int n, int E, int threads, const char* out_path) {
+    uint64_t seed = ((uint64_t)rand() << 32) ^ (uint64_t)rand();
+    if (threads <= 0) threads = max_threads();
+
+    double t0 = now_seconds();
+    Edge* edges = sample_gnm_edges(n, E, seed, threads);
+    double t_sample = now_seconds() - t0;
+
+    t0 = now_seconds();
+    GraphCSR* g = build_csr_from_edges(n, edges, E, out_path != NULL);
+    double t_build = now_seconds() - t0;
+
+    printf("G(n, m) sample: n=%d, E=%d, threads=%d\n", n, E, threads);
+    printf("Sampling: %.3f s (%.1f M edges/s), edge array %zu Bytes\n",
+        t_sample, E / t_sample / 1e6, (size_t)E * sizeof(Edge));
+    printf("CSR build: %.3f s, memory %zu Bytes\n", t_build, gc_memory_bytes(g));
+    if (out_path) {
+        t0 = now_seconds();
+        if (gc_save_file(g, out_path) == 0)
+            printf("Graph file: %s written in %.3f s\n", out_path, now_seconds() - t0);
+    }
+
+    gc_free(g);
+    free(edges);
+}
+
+// Load G(n, E) as one insert batch, then stream `batches` mixed batches
+// (half inserts of random pairs, half deletes of earlier inserts)
+static void run_batch_benchmark(int n, int E, int batch_size, int batches) {
+    if (n < 2 || E < 0 || batch_size < 1 || batches < 0) {
+        fprintf(stderr, "usage: Hw6 batch n E batch_size batches  (n >= 2, E >= 0, batch_size >= 1)\n");
+        return;
+    }
+    uint64_t seed = ((uint64_t)rand() << 32) ^ (uint64_t)rand();
+    Edge* base = sample_gnm_edges(n, E, seed, 0);
+    EdgeUpdate* batch = (EdgeUpdate*)malloc((size_t)(E > batch_size ? E : batch_size) * sizeof(EdgeUpdate));
+    GraphDyn* g = gd_create(n);
+    Rng r;
+    rng_seed(&r, seed, 1);
+
+    for (int i = 0; i < E; ++i) batch[i] = (EdgeUpdate){ base[i].u, base[i].v, 1 };
+    double t0 = now_seconds();
+    gd_apply_batch(g, batch, (size_t)E);
+    double t_load = now_seconds() - t0;
+
+    // deletions target edges from `base` that were inserted earlier
+    long long applied = 0;
+    size_t del_cursor = 0;
+    t0 = now_seconds();
+    for (int b = 0; b < batches; ++b) {
+        for (int i = 0; i < batch_size; ++i) {
+            if (i % 2 == 0 || E == 0) {
+                int u = (int)rng_below(&r, (uint64_t)n), v = (int)rng_below(&r, (uint64_t)n);
+                if (u == v) v = (v + 1) % n;
+                batch[i] = (EdgeUpdate){ u, v, 1 };
+            }
+            else {
+                Edge e = base[del_cursor++ % (size_t)E];
+                batch[i] = (EdgeUpdate){ e.u, e.v, 0 };
+            }
+        }
+        gd_apply_batch(g, batch, (size_t)batch_size);
+        applied += batch_size;
+    }
+    double t_stream = now_seconds() - t0;
+
+    long long half_edges = gd_live_half_edges(g);
+    printf("Batched updates: n=%d, initial E=%d, %d batches x %d updates, threads=%d\n",
+        n, E, batches, batch_size, max_threads());
+    printf("Initial load: %.3f s (%.1f M updates/s)\n", t_load, E / t_load / 1e6);
+    printf("Sustained: %.3f s (%.1f M updates/s)\n", t_stream, applied / t_stream / 1e6);
+    printf("Live edges: %lld (half-edges even: %s), tombstones %lld of %lld slots, %d compactions\n",
+        half_edges / 2, half_edges % 2 == 0 ? "yes" : "NO", g->tombstones, g->slots, g->compactions);
+
+    gd_free(g);
+    free(batch);
+    free(base);
+}
+
+// Serial list build vs serial CSR vs parallel CSR (with sort + dedup) on
+// G(n, E) plus 10% duplicated edges
+static void run_build_benchmark(int n, int E) {
+    uint64_t seed = ((uint64_t)rand() << 32) ^ (uint64_t)rand();
+    Edge* base = sample_gnm_edges(n, E, seed, 0);
+    long long dups = E / 10, total = E + dups;
+    Edge* edges = (Edge*)malloc((size_t)total * sizeof(Edge) + sizeof(Edge));
+    memcpy(edges, base, (size_t)E * sizeof(Edge));
+    for (long long i = 0; i < dups; ++i) edges[E + i] = (Edge){ base[i * 7 % E].v, base[i * 7 % E].u };
+
+    printf("CSR construction: n=%d, E=%d (+%lld duplicates), threads=%d\n", n, E, dups, max_threads());
+
+    if (E <= 2000000) {
+        double t0 = now_seconds();
+        GraphList* gl = build_list_from_edges(n, edges, (int)total);
+        printf("Adjacency list (serial, dup scan): %.3f s\n", now_seconds() - t0);
+        gl_free(gl);
+    }
+    else printf("Adjacency list (serial, dup scan): skipped for E > 2M\n");
+
+    double t0 = now_seconds();
+    GraphCSR* ref = build_csr_from_edges(n, base, E, 1);
+    printf("CSR serial (unique input, sorted): %.3f s\n", now_seconds() - t0);
+
+    t0 = now_seconds();
+    GraphCSR* par = build_csr_parallel(n, edges, total, 1);
+    printf("CSR parallel (sort + dedup):       %.3f s\n", now_seconds() - t0);
+
+    int same = ref->offsets[n] == par->offsets[n]
+        && memcmp(ref->offsets, par->offsets, ((size_t)n + 1) * sizeof(int64_t)) == 0
+        && memcmp(ref->nbrs, par->nbrs, (size_t)ref->offsets[n] * sizeof(int)) == 0;
+    printf("Parallel CSR matches serial CSR: %s (%lld half-edges)\n", same ? "yes" : "NO",
+        (long long)par->offsets[n]);
+
+    gc_free(ref);
+    gc_free(par);
+    free(edges);
+    free(base);
+}
+
+/* ---------- Graph files ---------- */
+
+typedef struct { int v, w; } WeightedNbr;
+
+static int cmp_weighted_nbr(const void* a, const void* b) {
+    const WeightedNbr* x = (const WeightedNbr*)a;
+    const WeightedNbr* y = (const WeightedNbr*)b;
+    if (x->v != y->v) return (x->v > y->v) - (x->v < y->v);
+    return (x->w > y->w) - (x->w < y->w);
+}
+
+// Weighted input: counting sort into (neighbor, weight) pairs, then sort +
+// dedup each list keeping the lightest parallel edge. Self-loops are dropped.
+static int save_weighted_csr(const char* path, int n, const Edge* edges, const int* weight, long long E) {
+    int64_t* off = (int64_t*)calloc((size_t)n + 1, sizeof(int64_t));
+    for (long long i = 0; i < E; ++i)
+        if (edges[i].u != edges[i].v) { off[edges[i].u + 1]++; off[edges[i].v + 1]++; }
+    for (int u = 0; u < n; ++u) off[u + 1] += off[u];
+    WeightedNbr* adj = (WeightedNbr*)malloc((size_t)off[n] * sizeof(WeightedNbr) + sizeof(WeightedNbr));
+    int64_t* cursor = (int64_t*)malloc((size_t)n * sizeof(int64_t) + sizeof(int64_t));
+    memcpy(cursor, off, (size_t)n * sizeof(int64_t));
+    for (long long i = 0; i < E; ++i) {
+        if (edges[i].u == edges[i].v) continue;
+        adj[cursor[edges[i].u]++] = (WeightedNbr){ edges[i].v, weight[i] };
+        adj[cursor[edges[i].v]++] = (WeightedNbr){ edges[i].u, weight[i] };
+    }
+    free(cursor);
+
+    int32_t* nbrs = (int32_t*)malloc((size_t)off[n] * sizeof(int32_t) + sizeof(int32_t));
+    int32_t* wts = (int32_t*)malloc((size_t)off[n] * sizeof(int32_t) + sizeof(int32_t));
+    int64_t k = 0, start = 0;
+    for (int u = 0; u < n; ++u) {
+        int64_t end = off[u + 1];
+        qsort(adj + start, (size_t)(end - start), sizeof(WeightedNbr), cmp_weighted_nbr);
+        off[u] = k;
+        for (int64_t i = start; i < end; ++i)
+            if (i == start || adj[i].v != adj[i - 1].v) { nbrs[k] = adj[i].v; wts[k] = adj[i].w; ++k; }
+        start = end;
+    }
+    off[n] = k;
+    int rc = gf_write(path, (uint64_t)n, off, nbrs, wts, GF_UNDIRECTED | GF_SORTED);
+    free(adj);
+    free(nbrs);
+    free(wts);
+    free(off);
+    return rc;
+}
+
+// Text edge list -> binary graph file. One "u v [w]" per line, ids >= 0,
+// '#' / '%' comment lines; n = largest id + 1. Undirected, sorted, deduped.
+static int convert_edge_list(const char* in_path, const char* out_path) {
+    FILE* fp = fopen(in_path, "r");
+    if (!fp) { perror(in_path); return 1; }
+    size_t cap = 1 << 16;
+    long long E = 0, line_no = 0, max_id = -1;
+    Edge* edges = (Edge*)malloc(cap * sizeof(Edge));
+    int* weight = (int*)malloc(cap * sizeof(int));
+    int weighted = 0;
+    char line[256];
+
+    double t0 = now_seconds();
+    while (fgets(line, sizeof(line), fp)) {
+        char *p = line, *end;
+        line_no++;
+        while (*p == ' ' || *p == '\t') ++p;
+        if (*p == '#' || *p == '%' || *p == '\n' || *p == '\r' || *p == '\0') continue;
+        long long u = strtoll(p, &end, 10);
+        if (end == p) goto bad;
+        p = end;
+        long long v = strtoll(p, &end, 10);
+        if (end == p) goto bad;
+        p = end;
+        long long w = strtoll(p, &end, 10);
+        if (end != p) weighted = 1;
+        else w = 1;
+        if (u < 0 || v < 0 || u >= INT32_MAX || v >= INT32_MAX || w < INT32_MIN || w > INT32_MAX) goto bad;
+        if ((size_t)E == cap) {
+            cap *= 2;
+            edges = (Edge*)realloc(edges, cap * sizeof(Edge));
+            weight = (int*)realloc(weight, cap * sizeof(int));
+        }
+        edges[E] = (Edge){ (int)u, (int)v };
+        weight[E++] = (int)w;
+        if (u > max_id) max_id = u;
+        if (v > max_id) max_id = v;
+    }
+    fclose(fp);
+    double t_parse = now_seconds() - t0;
+
+    int n = (int)(max_id + 1), rc;
+    t0 = now_seconds();
+    if (weighted) rc = save_weighted_csr(out_path, n, edges, weight, E);
+    else {
+        GraphCSR* g = build_csr_parallel(n, edges, E, 1);
+        rc = gc_save_file(g, out_path);
+        gc_free(g);
+    }
+    printf("%s: %lld edge lines, n=%d, %s; parse %.3f s, build + write %.3f s -> %s\n",
+        in_path, E, n, weighted ? "weighted" : "unweighted", t_parse, now_seconds() - t0, out_path);
+    free(edges);
+    free(weight);
+    return rc ? 1 : 0;
+
+bad:
+    fprintf(stderr, "%s:%lld: expected \"u v [w]\" with 0 <= id < 2^31-1\n", in_path, line_no);
+    fclose(fp);
+    free(edges);
+    free(weight);
+    return 1;
+}
+
+// Map a graph file and report start-up cost plus a scan over the mapping
+static int run_load_benchmark(const char* path, int verify) {
+    double t0 = now_seconds();
+    GraphCSR* g = gc_open_file(path, verify);
+    double t_open = now_seconds() - t0;
+    if (!g) return 1;
+
+    int64_t half_edges = g->offsets[g->n];
+    int max_deg = 0;
+    for (int u = 0; u < g->n; ++u)
+        if (g->offsets[u + 1] - g->offsets[u] > max_deg) max_deg = (int)(g->offsets[u + 1] - g->offsets[u]);
+    printf("%s: n=%d, half-edges=%lld, %s%s, file %zu Bytes (%s)\n", path, g->n, (long long)half_edges,
+        g->sorted ? "sorted" : "unsorted", g->file->weights ? ", weighted" : "",
+        g->file->size, g->file->mapped ? "mmap" : "read into memory");
+    printf("Open%s: %.3f ms\n", verify ? " + checksum and list verify" : "", t_open * 1e3);
+    printf("Max degree: %d, average degree: %.2f\n", max_deg, g->n ? (double)half_edges / g->n : 0.0);
+    printf("Neighbor scan throughput: %.1f M neighbors/s\n",
+        measure_scan_throughput(scan_csr, g, (size_t)half_edges) / 1e6);
+    gc_free(g);
+    return 0;
+}
+
+// Compressed CSR vs plain CSR (and the linked list it would replace):
+// bytes per half-edge, neighbor-scan throughput, and a full equality check
+static void run_compress_benchmark(const GraphCSR* c) {
+    int n = c->n;
+    int64_t half_edges = c->offsets[n];
+    double per = half_edges ? 1.0 / (double)half_edges : 0.0;
+
+    double t0 = now_seconds();
+    GraphCompressed* g = build_compressed_from_csr(c);
+    double t_build = now_seconds() - t0;
+
+    // decoded lists are ascending; an unsorted CSR is compared list by list after sorting
+    int* buf = (int*)malloc(((size_t)g->max_degree + 4) * sizeof(int));
+    int* want = (int*)malloc(((size_t)g->max_degree + 1) * sizeof(int));
+    int same = 1;
+    for (int u = 0; u < n && same; ++u) {
+        int deg = gz_decode_list(g, u, buf);
+        size_t d = (size_t)(c->offsets[u + 1] - c->offsets[u]);
+        memcpy(want, c->nbrs + c->offsets[u], d * sizeof(int));
+        if (!c->sorted) sort_ints(want, d);
+        same = deg == gz_degree(g, u) && (size_t)deg == d && memcmp(buf, want, d * sizeof(int)) == 0;
+    }
+    free(want);
+    CmpCounter cc_csr = { 0 }, cc_gz = { 0 };
+    for (int i = 0; i < 100000 && same && n > 1; ++i) {
+        int u, v;
+        make_random_pair(n, &u, &v);
+        same = gc_has_edge((GraphCSR*)c, u, v, &cc_csr) == gz_has_edge(g, u, v, &cc_gz);
+    }
+
+    size_t list_bytes = sizeof(GraphList) + (size_t)n * sizeof(Node*) + (size_t)half_edges * sizeof(Node);
+    size_t csr_bytes = gc_memory_bytes((GraphCSR*)c);
+    size_t gz_bytes = gz_memory_bytes(g);
+    printf("Compressed CSR: n=%d, half-edges=%lld, max degree %d, %s decode\n", n, (long long)half_edges,
+        g->max_degree, svb_decoder_name());
+    printf("Encode: %.3f s, decodes identical to CSR: %s\n", t_build, same ? "yes" : "NO");
+    printf("Adjacency list: %zu Bytes (%.2f B/half-edge)\n", list_bytes, list_bytes * per);
+    printf("CSR:            %zu Bytes (%.2f B/half-edge)\n", csr_bytes, csr_bytes * per);
+    printf("Compressed:     %zu Bytes (%.2f B/half-edge), %.2fx smaller than CSR, %.2fx than list\n",
+        gz_bytes, gz_bytes * per, (double)csr_bytes / gz_bytes, (double)list_bytes / gz_bytes);
+    printf("Scan CSR:               %.1f M neighbors/s\n",
+        measure_scan_throughput(scan_csr, c, (size_t)half_edges) / 1e6);
+    printf("Scan compressed (iter): %.1f M neighbors/s\n",
+        measure_scan_throughput(scan_compressed, g, (size_t)half_edges) / 1e6);
+    GzBulkScan bs = { g, buf };
+    printf("Scan compressed (bulk): %.1f M neighbors/s\n",
+        measure_scan_throughput(scan_compressed_bulk, &bs, (size_t)half_edges) / 1e6);
+    free(buf);
+    gz_free(g);
+}
+
+// side x side 4-neighbor grid with randomly permuted vertex IDs
+static GraphCSR* make_scrambled_grid(int side) {
+    int n = side * side;
+    long long E = 2LL * side * (side - 1), k = 0;
+    int* label = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    Edge* edges = (Edge*)malloc((size_t)E * sizeof(Edge) + sizeof(Edge));
+    Rng r;
+    rng_seed(&r, ((uint64_t)rand() << 32) ^ (uint64_t)rand(), 0);
+    for (int i = 0; i < n; ++i) label[i] = i;
+    for (int i = n - 1; i > 0; --i) {
+        int j = (int)rng_below(&r, (uint64_t)i + 1), t = label[i];
+        label[i] = label[j];
+        label[j] = t;
+    }
+    for (int y = 0; y < side; ++y)
+        for (int x = 0; x < side; ++x) {
+            int id = label[y * side + x];
+            if (x + 1 < side) edges[k++] = (Edge){ id, label[y * side + x + 1] };
+            if (y + 1 < side) edges[k++] = (Edge){ id, label[(y + 1) * side + x] };
+        }
+    GraphCSR* g = build_csr_parallel(n, edges, E, 1);
+    free(edges);
+    free(label);
+    return g;
+}
+
+// Graph argument forms shared by the CSR benchmarks:
+//   n E -> G(n, E) sample, grid side -> scrambled grid, file.bin -> mapped file
+static GraphCSR* csr_from_args(int argc, char* argv[]) {
+    if (argc >= 2 && strcmp(argv[0], "grid") == 0) return make_scrambled_grid(atoi(argv[1]));
+    if (argc >= 2) {
+        int n = atoi(argv[0]), E = atoi(argv[1]);
+        Edge* edges = sample_gnm_edges(n, E, ((uint64_t)rand() << 32) ^ (uint64_t)rand(), 0);
+        GraphCSR* g = build_csr_parallel(n, edges, E, 1);
+        free(edges);
+        return g;
+    }
+    return argc >= 1 ? gc_open_file(argv[0], 0) : NULL;
+}
+
+// Original vs degree-sorted vs BFS vs RCM labels: ID locality, compressed
+// size, BFS time from the same (relabelled) sources, gather throughput
+static void run_reorder_benchmark(const GraphCSR* c) {
+    static const char* names[4] = { "original", "degree", "BFS", "RCM" };
+    enum { SOURCES = 8 };
+    int n = c->n, src[SOURCES];
+    int64_t half_edges = c->offsets[n];
+    int* new_to_old = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int* old_to_new = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int* dist = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int* queue = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int* x = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    for (int i = 0; i < SOURCES; ++i) src[i] = n ? rand() % n : 0;
+    for (int v = 0; v < n; ++v) x[v] = v & 1023;
+
+    printf("Vertex reordering: n=%d, half-edges=%lld, BFS from %d sources\n", n, (long long)half_edges, SOURCES);
+    printf("%-9s %10s %12s %14s %12s %14s\n", "order", "relabel s", "mean |u-v|", "gz data B/e",
+        "BFS ms", "gather M/s");
+    for (int o = 0; o < 4; ++o) {
+        double t0 = now_seconds();
+        if (o == 0) for (int v = 0; v < n; ++v) new_to_old[v] = v;
+        else if (o == 1) order_by_degree(c, new_to_old, 1);
+        else if (o == 2) order_bfs(c, new_to_old);
+        else order_rcm(c, new_to_old);
+        GraphCSR* g = gc_permute(c, new_to_old, old_to_new);
+        double t_relabel = now_seconds() - t0;
+
+        double gap = 0;
+        for (int u = 0; u < n; ++u)
+            for (int64_t i = g->offsets[u]; i < g->offsets[u + 1]; ++i) gap += abs(g->nbrs[i] - u);
+        GraphCompressed* gz = build_compressed_from_csr(g);
+
+        // dist sums are label-independent, so they double as a correctness check
+        long long check = 0;
+        t0 = now_seconds();
+        for (int i = 0; i < SOURCES && n; ++i) {
+            check += gc_bfs(g, old_to_new[src[i]], dist, queue);
+            for (int v = 0; v < n; ++v) check += dist[v] > 0 ? dist[v] : 0;
+        }
+        double t_bfs = now_seconds() - t0;
+
+        GatherScan gs = { g, x };
+        printf("%-9s %10.3f %12.1f %14.2f %12.2f %14.1f  (check %lld)\n", names[o], t_relabel,
+            half_edges ? gap / half_edges : 0.0, half_edges ? (double)gz->offsets[n] / half_edges : 0.0,
+            t_bfs * 1e3 / SOURCES, measure_scan_throughput(scan_csr_gather, &gs, (size_t)half_edges) / 1e6, check);
+        gz_free(gz);
+        gc_free(g);
+    }
+    free(new_to_old);
+    free(old_to_new);
+    free(dist);
+    free(queue);
+    free(x);
+}
+
+// Triangle counting and common-neighbor queries with each intersection
+// kernel, against the unsorted adjacency list (nested scans) on a sample
+// and the bit-packed matrix (row AND) as a reference when n is small
+static void run_triangle_benchmark(const GraphCSR* g) {
+    static const char* names[4] = { "merge", "gallop", "simd", "adaptive" };
+    IntersectFn fns[4] = { intersect_merge, intersect_gallop, intersect_simd, intersect_adaptive };
+    enum { QUERIES = 1000000, LIST_QUERIES = 10000 };
+    int n = g->n;
+    int64_t half_edges = g->offsets[n];
+    if (!g->sorted || n < 2) { printf("triangles: need a sorted CSR with n >= 2\n"); return; }
+
+    double t0 = now_seconds();
+    GraphCSR* f = build_forward_csr(g);
+    double t_orient = now_seconds() - t0;
+    printf("Triangles / common neighbors: n=%d, edges=%lld, threads=%d\n", n, (long long)half_edges / 2, max_threads());
+    int fwd_max = 0;
+    for (int u = 0; u < n; ++u)
+        if (csr_degree(f, u) > fwd_max) fwd_max = csr_degree(f, u);
+    printf("Orientation by degree: %.3f s, forward max degree %d\n", t_orient, fwd_max);
+    for (int k = 0; k < 4; ++k) {
+        t0 = now_seconds();
+        long long tri = count_triangles(f, fns[k]);
+        printf("Triangles (%-8s): %lld in %.3f s\n", names[k], tri, now_seconds() - t0);
+    }
+
+    // queries: half are edges (non-trivial overlap), half random pairs
+    Edge* pairs = (Edge*)malloc((size_t)QUERIES * sizeof(Edge));
+    int* out = (int*)malloc((size_t)QUERIES * sizeof(int));
+    int* ref = (int*)malloc((size_t)QUERIES * sizeof(int));
+    for (int i = 0; i < QUERIES; ++i) {
+        int u = rand() % n;
+        if (i % 2 == 0 && csr_degree(g, u) > 0) pairs[i] = (Edge){ u, g->nbrs[g->offsets[u] + rand() % csr_degree(g, u)] };
+        else { int v; make_random_pair(n, &u, &v); pairs[i] = (Edge){ u, v }; }
+    }
+    common_neighbors_batch(g, pairs, QUERIES, intersect_merge, ref);
+    for (int k = 0; k < 4; ++k) {
+        t0 = now_seconds();
+        long long total = common_neighbors_batch(g, pairs, QUERIES, fns[k], out);
+        double dt = now_seconds() - t0;
+        printf("Common neighbors (%-8s): %d queries, %.1f ns/query, total %lld, matches merge: %s\n", names[k],
+            QUERIES, dt * 1e9 / QUERIES, total, memcmp(out, ref, (size_t)QUERIES * sizeof(int)) == 0 ? "yes" : "NO");
+    }
+
+    if (half_edges <= 20000000) {
+        // unsorted linked list, the representation this replaces: nested scans
+        GraphList* gl = gl_create(n);
+        for (int u = 0; u < n; ++u)
+            for (int64_t i = g->offsets[u]; i < g->offsets[u + 1]; ++i) {
+                Node* node = (Node*)malloc(sizeof(Node));
+                node->v = g->nbrs[i];
+                node->next = gl->head[u];
+                gl->head[u] = node;
+                gl->node_count++;
+            }
+        int same = 1;
+        t0 = now_seconds();
+        for (int i = 0; i < LIST_QUERIES; ++i) {
+            int c = 0;
+            for (Node* a = gl->head[pairs[i].u]; a; a = a->next)
+                for (Node* b = gl->head[pairs[i].v]; b; b = b->next) c += a->v == b->v;
+            same &= c == ref[i];
+        }
+        double dt = now_seconds() - t0;
+        printf("Common neighbors (list, nested scans): %.1f ns/query over %d queries, matches: %s\n",
+            dt * 1e9 / LIST_QUERIES, LIST_QUERIES, same ? "yes" : "NO");
+        gl_free(gl);
+    }
+    if (n <= 65536) {
+        GraphBitMatrix* gb = gb_create(n);
+        CmpCounter tmp = { 0 };
+        uint64_t* scratch = (uint64_t*)aligned_calloc64(gb->words_per_row * sizeof(uint64_t));
+        for (int u = 0; u < n; ++u)
+            for (int64_t i = g->offsets[u]; i < g->offsets[u + 1]; ++i) gb_add_edge(gb, u, g->nbrs[i], &tmp);
+        int same = 1;
+        for (int i = 0; i < QUERIES && same; ++i) same = gb_common_neighbors(gb, pairs[i].u, pairs[i].v, scratch) == ref[i];
+        long long tri = 0;
+        for (int u = 0; u < n; ++u)
+            for (int64_t i = g->offsets[u]; i < g->offsets[u + 1]; ++i)
+                if (g->nbrs[i] > u) tri += gb_common_neighbors(gb, u, g->nbrs[i], scratch);
+        printf("Bit-matrix reference: queries match: %s, triangles %lld\n", same ? "yes" : "NO", tri / 3);
+        aligned_free64(scratch);
+        gb_free(gb);
+    }
+    free(pairs);
+    free(out);
+    free(ref);
+    gc_free(f);
+}
+
+// 2-hop and k-step reachability on a random G(n, n*deg/2) bit-packed
+// matrix, spot-checked against row ANDs and a bounded BFS
+static void run_matmul_benchmark(int n, int deg, int k) {
+    long long E = (long long)n * deg / 2;
+    Edge* edges = sample_gnm_edges(n, (int)E, ((uint64_t)rand() << 32) ^ (uint64_t)rand(), 0);
+    GraphBitMatrix* g = build_bitmatrix_from_edges(n, edges, (int)E);
+    free(edges);
+    printf("Boolean matrix multiply: n=%d, avg degree %d, k=%d, threads=%d, %zu Bytes per matrix\n",
+        n, deg, k, max_threads(), gb_memory_bytes(g));
+
+    double t0 = now_seconds();
+    GraphBitMatrix* two = gb_two_hop(g);
+    double dt = now_seconds() - t0;
+    printf("2-hop (A*A): %.3f s, %.2f G output bits/s, avg 2-hop set %.1f\n", dt,
+        (double)n * n / dt / 1e9, (double)gb_count_bits(two) / n);
+
+    // (A*A)[u][w] = 1 iff rows u and w share a neighbor (A is symmetric)
+    uint64_t* scratch = (uint64_t*)aligned_calloc64(g->words_per_row * sizeof(uint64_t));
+    int same = 1;
+    for (int i = 0; i < 2000 && same; ++i) {
+        int u = rand() % n, w = rand() % n;
+        if (i % 2 == 0 && gb_degree(g, u) > 0) {
+            // bias half the probes toward actual 2-hop pairs
+            uint64_t* r = gb_row(g, u);
+            size_t x = 0;
+            while (!r[x]) ++x;
+            int v = (int)(x * 64) + bit_ctz64(r[x]);
+            uint64_t* rv = gb_row(g, v);
+            for (x = 0; !rv[x]; ++x) {}
+            w = (int)(x * 64) + bit_ctz64(rv[x]);
+        }
+        int expect = gb_common_neighbors(g, u, w, scratch) > 0;
+        same = ((gb_row(two, u)[w / 64] >> (w % 64)) & 1) == (uint64_t)expect;
+    }
+    printf("2-hop spot check (2000 pairs): %s\n", same ? "ok" : "MISMATCH");
+    aligned_free64(scratch);
+    gb_free(two);
+
+    t0 = now_seconds();
+    GraphBitMatrix* reach = gb_reach_within(g, k);
+    dt = now_seconds() - t0;
+    printf("Reach within %d steps ((I|A)^%d): %.3f s, avg reachable %.1f\n", k, k, dt,
+        (double)gb_count_bits(reach) / n);
+
+    int* dist = (int*)malloc((size_t)n * sizeof(int));
+    int* queue = (int*)malloc((size_t)n * sizeof(int));
+    same = 1;
+    for (int probe = 0; probe < 4 && same; ++probe) {
+        int s = rand() % n, head = 0, tail = 0;
+        for (int v = 0; v < n; ++v) dist[v] = -1;
+        dist[s] = 0;
+        queue[tail++] = s;
+        while (head < tail) {
+            int u = queue[head++];
+            if (dist[u] == k) continue;
+            uint64_t* r = gb_row(g, u);
+            for (size_t x = 0; x < g->words_per_row; ++x)
+                for (uint64_t bits = r[x]; bits; bits &= bits - 1) {
+                    int v = (int)(x * 64) + bit_ctz64(bits);
+                    if (dist[v] < 0) { dist[v] = dist[u] + 1; queue[tail++] = v; }
+                }
+        }
+        for (int v = 0; v < n && same; ++v)
+            same = ((gb_row(reach, s)[v / 64] >> (v % 64)) & 1) == (uint64_t)(dist[v] >= 0);
+    }
+    printf("Reach check vs bounded BFS (4 sources): %s\n", same ? "ok" : "MISMATCH");
+    free(dist);
+    free(queue);
+    gb_free(reach);
+    gb_free(g);
+}
+
+/* ---------- Size / density sweep ---------- */
+
+// One row of the sweep table: type-erased entry points for a representation.
+// add/remove are NULL for read-only ones; max_n bounds the O(n^2) layouts
+// and scan_build marks builds that scan the list per insert (O(E * degree)).
+typedef struct {
+    const char* name;
+    int max_n;
+    int scan_build;
+    void* (*build)(int n, Edge* edges, int E);
+    void (*destroy)(void* g);
+    int (*has_edge)(void* g, int u, int v, CmpCounter* cc);
+    void (*add_edge)(void* g, int u, int v, CmpCounter* cc);
+    void (*remove_edge)(void* g, int u, int v, CmpCounter* cc);
+    size_t (*memory_bytes)(void* g);
+    ScanFn scan;
+} SweepRepr;
+
+#define SWEEP_WRAP(p, T, builder)                                                                        \
+    static void* p##_sw_build(int n, Edge* e, int E) { return builder(n, e, E); }                       \
+    static void p##_sw_free(void* g) { p##_free((T*)g); }                                               \
+    static int p##_sw_has(void* g, int u, int v, CmpCounter* cc) { return p##_has_edge((T*)g, u, v, cc); } \
+    static void p##_sw_add(void* g, int u, int v, CmpCounter* cc) { p##_add_edge((T*)g, u, v, cc); }    \
+    static void p##_sw_remove(void* g, int u, int v, CmpCounter* cc) { p##_remove_edge((T*)g, u, v, cc); } \
+    static size_t p##_sw_bytes(void* g) { return p##_memory_bytes((T*)g); }
+
+SWEEP_WRAP(gm, GraphMatrix, build_matrix_from_edges)
+SWEEP_WRAP(gb, GraphBitMatrix, build_bitmatrix_from_edges)
+SWEEP_WRAP(gl, GraphList, build_list_from_edges)
+SWEEP_WRAP(gs, GraphHashSet, build_hashset_from_edges)
+SWEEP_WRAP(gh, GraphHybrid, build_hybrid_from_edges)
+#undef SWEEP_WRAP
+
+static void* gc_sw_build(int n, Edge* e, int E) { return build_csr_parallel(n, e, E, 1); }
+static void gc_sw_free(void* g) { gc_free((GraphCSR*)g); }
+static int gc_sw_has(void* g, int u, int v, CmpCounter* cc) { return gc_has_edge((GraphCSR*)g, u, v, cc); }
+static size_t gc_sw_bytes(void* g) { return gc_memory_bytes((GraphCSR*)g); }
+
+static void* gz_sw_build(int n, Edge* e, int E) {
+    GraphCSR* c = build_csr_parallel(n, e, E, 1);
+    GraphCompressed* g = build_compressed_from_csr(c);
+    gc_free(c);
+    return g;
+}
+static void gz_sw_free(void* g) { gz_free((GraphCompressed*)g); }
+static int gz_sw_has(void* g, int u, int v, CmpCounter* cc) { return gz_has_edge((GraphCompressed*)g, u, v, cc); }
+static size_t gz_sw_bytes(void* g) { return gz_memory_bytes((GraphCompressed*)g); }
+
+static const SweepRepr sweep_reprs[] = {
+    { "matrix", 32768, 0, gm_sw_build, gm_sw_free, gm_sw_has, gm_sw_add, gm_sw_remove, gm_sw_bytes, scan_matrix },
+    { "bitmatrix", 65536, 0, gb_sw_build, gb_sw_free, gb_sw_has, gb_sw_add, gb_sw_remove, gb_sw_bytes, scan_bitmatrix },
+    { "list", INT32_MAX, 1, gl_sw_build, gl_sw_free, gl_sw_has, gl_sw_add, gl_sw_remove, gl_sw_bytes, scan_list },
+    { "hashset", INT32_MAX, 0, gs_sw_build, gs_sw_free, gs_sw_has, gs_sw_add, gs_sw_remove, gs_sw_bytes, scan_hashset },
+    { "hybrid", INT32_MAX, 0, gh_sw_build, gh_sw_free, gh_sw_has, gh_sw_add, gh_sw_remove, gh_sw_bytes, scan_hybrid },
+    { "csr", INT32_MAX, 0, gc_sw_build, gc_sw_free, gc_sw_has, NULL, NULL, gc_sw_bytes, scan_csr },
+    { "compressed", INT32_MAX, 0, gz_sw_build, gz_sw_free, gz_sw_has, NULL, NULL, gz_sw_bytes, scan_compressed },
+};
+
+// Every representation at n = 64, 128, ... max_n and each average degree in
+// `degrees` (comma list, 0 = dense: n/2). One CSV row per (repr, n, degree):
+// build time, bytes/edge, ns and comparisons per has_edge and per update,
+// ns per scanned neighbor. Progress goes to stderr.
+static int run_sweep(int max_n, const char* csv_path, const char* degrees) {
+    enum { CHECKS = 200000, UPDATES = 20000 };
+    // validate the degree list first: each entry a number >= 0, comma separated
+    for (const char* d = degrees; *d; d += *d == ',') {
+        char* end;
+        long long deg = strtoll(d, &end, 10);
+        if (end == d || deg < 0 || (*end != ',' && *end != '\0')) {
+            fprintf(stderr, "sweep: bad degree list \"%s\"\n"
+                "usage: Hw6 sweep max_n out.csv [deg,deg,...]  (integers >= 0, 0 = dense: n/2)\n", degrees);
+            return 1;
+        }
+        d = end;
+    }
+    FILE* out = fopen(csv_path, "w");
+    if (!out) { perror(csv_path); return 1; }
+    fprintf(out, "repr,n,avg_degree,edges,build_s,bytes,bytes_per_edge,check_ns,check_cmp,"
+        "update_ns,update_cmp,scan_ns_per_neighbor\n");
+    Edge* probes = (Edge*)malloc(CHECKS * sizeof(Edge));
+    Edge* pairs = (Edge*)malloc(UPDATES * sizeof(Edge));
+
+    for (long long n = 64; n <= max_n; n *= 2) {
+        for (const char* d = degrees; *d; d += *d == ',') {
+            char* end;
+            long long deg = strtoll(d, &end, 10);
+            d = end;
+            if (deg <= 0) deg = n / 2;
+            if (deg > n - 1) deg = n - 1;
+            long long E = n * deg / 2;
+            if (E > (1LL << 26)) { fprintf(stderr, "sweep: n=%lld deg=%lld skipped (E > 2^26)\n", n, deg); continue; }
+            Edge* edges = sample_gnm_edges((int)n, (int)E, ((uint64_t)rand() << 32) ^ (uint64_t)rand(), 0);
+            // half the probes are edges, half random pairs (mostly absent)
+            for (int i = 0; i < CHECKS; ++i) {
+                if (i % 2 == 0 && E > 0) probes[i] = edges[rand() % E];
+                else make_random_pair((int)n, &probes[i].u, &probes[i].v);
+            }
+
+            for (size_t r = 0; r < sizeof(sweep_reprs) / sizeof(sweep_reprs[0]); ++r) {
+                const SweepRepr* rep = &sweep_reprs[r];
+                if (n > rep->max_n) continue;
+                if (rep->scan_build && E * deg > (1LL << 26)) {
+                    fprintf(stderr, "sweep: %-10s n=%lld deg=%lld skipped (duplicate-scan build)\n", rep->name, n, deg);
+                    continue;
+                }
+                fprintf(stderr, "sweep: %-10s n=%lld deg=%lld\n", rep->name, n, deg);
+                double t0 = now_seconds();
+                void* g = rep->build((int)n, edges, (int)E);
+                double t_build = now_seconds() - t0;
+                size_t bytes = rep->memory_bytes(g);
+
+                CmpCounter cc = { 0 };
+                volatile int hits = 0;
+                t0 = now_seconds();
+                for (int i = 0; i < CHECKS; ++i) hits += rep->has_edge(g, probes[i].u, probes[i].v, &cc);
+                double t_check = now_seconds() - t0;
+
+                double t_update = 0;
+                long long updates = 0;
+                if (rep->add_edge) {
+                    // insert + delete of non-edges, so the graph is unchanged afterwards;
+                    // the pairs are drawn first and the whole batch is timed once
+                    int np = 0;
+                    for (int i = 0; i < UPDATES; ++i) {
+                        CmpCounter tmp = { 0 };
+                        make_random_pair((int)n, &pairs[np].u, &pairs[np].v);
+                        if (!rep->has_edge(g, pairs[np].u, pairs[np].v, &tmp)) np++;
+                    }
+                    t0 = now_seconds();
+                    for (int i = 0; i < np; ++i) {
+                        rep->add_edge(g, pairs[i].u, pairs[i].v, &cc);
+                        rep->remove_edge(g, pairs[i].u, pairs[i].v, &cc);
+                    }
+                    t_update = now_seconds() - t0;
+                    updates = 2LL * np;
+                }
+                double scan_rate = measure_scan_throughput(rep->scan, g, (size_t)E * 2);
+
+                fprintf(out, "%s,%lld,%lld,%lld,%.6f,%zu,%.3f,%.2f,%.3f,", rep->name, n, deg, E, t_build, bytes,
+                    E ? (double)bytes / E : 0.0, t_check * 1e9 / CHECKS, (double)cc.check_cmp / CHECKS);
+                if (updates) fprintf(out, "%.2f,%.3f,", t_update * 1e9 / updates,
+                    (double)(cc.insert_cmp + cc.delete_cmp) / updates);
+                else fprintf(out, ",,");
+                fprintf(out, "%.4f\n", scan_rate > 0 ? 1e9 / scan_rate : 0.0);
+                fflush(out);
+                rep->destroy(g);
+            }
+            free(edges);
+        }
+    }
+    free(probes);
+    free(pairs);
+    fclose(out);
+    printf("sweep written to %s\n", csv_path);
+    return 0;
+}
+
+// usage: Hw6                      -> representation comparison at N=100
+//        Hw6 sample n E [threads] [out.bin] -> streaming G(n, m) sampler + CSR build
+//        Hw6 convert edges.txt out.bin -> text edge list to binary graph file
+//        Hw6 load file.bin [verify] -> mmap a binary graph file (optionally check CRCs and lists)
+//        Hw6 compress n E | grid side | file.bin -> delta + Stream VByte compressed CSR vs CSR
+//        Hw6 reorder n E | grid side | file.bin  -> degree / BFS / RCM relabeling benchmark
+//        Hw6 triangles n E | grid side | file.bin -> intersection kernels, triangles, common neighbors
+//        Hw6 matmul n deg k       -> bit-packed boolean matrix multiply: 2-hop, reach within k
+//        Hw6 sweep max_n out.csv [deg,deg,...] -> every representation over n and density (0 = n/2)
+//        Hw6 batch n E batch_size batches -> batched parallel edge updates
+//        Hw6 build n E            -> serial vs parallel CSR construction
+int main(int argc, char* argv[]) {
+    srand((unsigned)time(NULL));
+
+    if (argc >= 4 && strcmp(argv[1], "sample") == 0) {
+        run_sample_benchmark(atoi(argv[2]), atoi(argv[3]), argc >= 5 ? atoi(argv[4]) : 0,
+            argc >= 6 ? argv[5] : NULL);
+        return 0;
+    }
+    if (argc >= 4 && strcmp(argv[1], "convert") == 0)
+        return convert_edge_list(argv[2], argv[3]);
+    if (argc >= 3 && (strcmp(argv[1], "compress") == 0 || strcmp(argv[1], "reorder") == 0
+        || strcmp(argv[1], "triangles") == 0)) {
+        GraphCSR* c = csr_from_args(argc - 2, argv + 2);
+        if (!c) return 1;
+        if (argv[1][0] == 'c') run_compress_benchmark(c);
+        else if (argv[1][0] == 'r') run_reorder_benchmark(c);
+        else run_triangle_benchmark(c);
+        gc_free(c);
+        return 0;
+    }
+    if (argc >= 3 && strcmp(argv[1], "load") == 0)
+        return run_load_benchmark(argv[2], argc >= 4 && strcmp(argv[3], "verify") == 0);
+    if (argc >= 4 && strcmp(argv[1], "build") == 0) {
+        run_build_benchmark(atoi(argv[2]), atoi(argv[3]));
+        return 0;
+    }
+    if (argc >= 4 && strcmp(argv[1], "sweep") == 0)
+        return run_sweep(atoi(argv[2]), argv[3], argc >= 5 ? argv[4] : "4,32,0");
+    if (argc >= 5 && strcmp(argv[1], "matmul") == 0) {
+        run_matmul_benchmark(atoi(argv[2]), atoi(argv[3]), atoi(argv[4]));
+        return 0;
+    }
+    if (argc >= 6 && strcmp(argv[1], "batch") == 0) {
+        run_batch_benchmark(atoi(argv[2]), atoi(argv[3]), atoi(argv[4]), atoi(argv[5]));
+        return 0;
+    }
 
     // SPARSE (100 edges)
     Edge* sparse = generate_random_edge_set(N, SPARSE_E);
     // DENSE (4000 edges)
     Edge* dense = generate_random_edge_set(N, DENSE_E);
 
-    // Build & run 4 cases using the SAME edge sets for fairness
+    // Build & run all cases using the SAME edge sets for fairness
     run_case_matrix("Case 1: Sparse + Adjacency Matrix", N, sparse, SPARSE_E);
     run_case_list("Case 2: Sparse + Adjacency List", N, sparse, SPARSE_E);
     run_case_matrix("Case 3: Dense  + Adjacency Matrix", N, dense, DENSE_E);
     run_case_list("Case 4: Dense  + Adjacency List", N, dense, DENSE_E);
+    run_case_csr("Case 5: Sparse + CSR", N, sparse, SPARSE_E);
+    run_case_csr("Case 6: Dense  + CSR", N, dense, DENSE_E);
+    run_case_bitmatrix("Case 7: Sparse + Bit-packed Matrix", N, sparse, SPARSE_E);
+    run_case_bitmatrix("Case 8: Dense  + Bit-packed Matrix", N, dense, DENSE_E);
+    run_case_hashset("Case 9: Sparse + Per-vertex Hash Set", N, sparse, SPARSE_E);
+    run_case_hashset("Case 10: Dense + Per-vertex Hash Set", N, dense, DENSE_E);
+    run_case_hybrid("Case 11: Sparse + Hybrid (array/bitset)", N, sparse, SPARSE_E);
+    run_case_hybrid("Case 12: Dense + Hybrid (array/bitset)", N, dense, DENSE_E);
 
     free(sparse);
     free(dense);
@@ -0,0 +1,220 @@
+/* file: cachesim.h
+ * Deterministic set-associative cache simulator for the search benchmarks
+ * (hw4.c, hw5.c, hw11.c). Search routines call CACHE_TOUCH(ptr, bytes) for
+ * every key/node they read; with -DCACHE_SIM the address stream is fed
+ * through an L1 -> L2 -> LLC model (LRU, fill on miss), otherwise the macro
+ * compiles to nothing. No hardware counters are used.
+ *
+ * Sizes come from the defaults below or from environment variables
+ *   CACHESIM_L1 / CACHESIM_L2 / CACHESIM_LLC = "<size>[K|M],<ways>"
+ *   CACHESIM_LINE = <line bytes>
+ * e.g. CACHESIM_L2=256K,4. Addresses are translated like an OS would:
+ * each 4 KiB virtual page gets the next free frame in first-touch order and
+ * keeps its offset, so set indices do not depend on where ASLR put the heap
+ * and the counts are identical from run to run.
+ */
+#ifndef CACHESIM_H
+#define CACHESIM_H
+
+#ifdef CACHE_SIM
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CACHESIM_LEVELS 3
+#define CACHESIM_PAGE_BITS 12
+
+/* header-only: unused helpers must not warn, and hw5 still builds as C89 */
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+#define CACHESIM_INLINE inline
+#elif defined(_MSC_VER)
+#define CACHESIM_INLINE __inline
+#elif defined(__GNUC__)
+#define CACHESIM_INLINE __inline__
+#else
+#define CACHESIM_INLINE
+#endif
+
+typedef struct {
+    const char* name;
+    size_t size, ways, sets;
+    unsigned long long* tags;   /* sets * ways, 0 = empty (tag is stored +1) */
+    unsigned long long* stamp;  /* last-use time per way, for LRU */
+    unsigned long long accesses, misses;
+} CacheLevel;
+
+/* virtual page -> frame, open addressing (power-of-two capacity) */
+typedef struct {
+    unsigned long long* vpn;    /* virtual page number + 1, 0 = empty */
+    unsigned long long* frame;
+    size_t cap, used;
+} CachePageMap;
+
+typedef struct {
+    CacheLevel level[CACHESIM_LEVELS];
+    CachePageMap pages;
+    size_t line;
+    unsigned long long clock;
+    int ready;
+} CacheSim;
+
+typedef struct {
+    unsigned long long accesses[CACHESIM_LEVELS];
+    unsigned long long misses[CACHESIM_LEVELS];
+} CacheStats;
+
+static CacheSim g_cachesim;
+
+/* "<size>[K|M],<ways>" -> size/ways; leaves defaults on parse failure */
+static CACHESIM_INLINE void cachesim_parse_env(const char* var, size_t* size, size_t* ways) {
+    const char* s = getenv(var);
+    char* end;
+    unsigned long v;
+    if (!s) return;
+    v = strtoul(s, &end, 10);
+    if (*end == 'K' || *end == 'k') { v <<= 10; end++; }
+    else if (*end == 'M' || *end == 'm') { v <<= 20; end++; }
+    if (v == 0) return;
+    *size = v;
+    if (*end == ',') {
+        v = strtoul(end + 1, NULL, 10);
+        if (v) *ways = v;
+    }
+}
+
+static CACHESIM_INLINE void cachesim_init(void) {
+    static const char* names[CACHESIM_LEVELS] = { "L1", "L2", "LLC" };
+    static const char* vars[CACHESIM_LEVELS] = { "CACHESIM_L1", "CACHESIM_L2", "CACHESIM_LLC" };
+    size_t sizes[CACHESIM_LEVELS] = { 32u << 10, 1u << 20, 32u << 20 };
+    size_t ways[CACHESIM_LEVELS] = { 8, 16, 16 };
+    const char* line = getenv("CACHESIM_LINE");
+    int i;
+
+    g_cachesim.line = line ? (size_t)strtoul(line, NULL, 10) : 64;
+    if (g_cachesim.line == 0) g_cachesim.line = 64;
+    for (i = 0; i < CACHESIM_LEVELS; i++) {
+        CacheLevel* c = &g_cachesim.level[i];
+        cachesim_parse_env(vars[i], &sizes[i], &ways[i]);
+        c->name = names[i];
+        c->size = sizes[i];
+        c->ways = ways[i];
+        c->sets = sizes[i] / (ways[i] * g_cachesim.line);
+        if (c->sets == 0) c->sets = 1;
+        c->tags = (unsigned long long*)calloc(c->sets * c->ways, sizeof(unsigned long long));
+        c->stamp = (unsigned long long*)calloc(c->sets * c->ways, sizeof(unsigned long long));
+        if (!c->tags || !c->stamp) { fprintf(stderr, "cachesim: malloc failed\n"); exit(1); }
+        c->accesses = c->misses = 0;
+    }
+    g_cachesim.clock = 0;
+    g_cachesim.ready = 1;
+}
+
+/* one line lookup in one level; returns 1 on hit, fills (LRU victim) on miss */
+static CACHESIM_INLINE int cachesim_level_access(CacheLevel* c, unsigned long long line_addr) {
+    size_t set = (size_t)(line_addr % c->sets);
+    unsigned long long tag = line_addr / c->sets + 1;
+    unsigned long long* tags = c->tags + set * c->ways;
+    unsigned long long* stamp = c->stamp + set * c->ways;
+    size_t w, victim = 0;
+
+    c->accesses++;
+    for (w = 0; w < c->ways; w++) {
+        if (tags[w] == tag) { stamp[w] = ++g_cachesim.clock; return 1; }
+        if (stamp[w] < stamp[victim]) victim = w;
+    }
+    c->misses++;
+    tags[victim] = tag;
+    stamp[victim] = ++g_cachesim.clock;
+    return 0;
+}
+
+static CACHESIM_INLINE size_t cachesim_page_slot(const CachePageMap* m, unsigned long long vpn) {
+    size_t h = (size_t)((vpn * 0x9E3779B97F4A7C15ULL) >> 32) & (m->cap - 1);
+    while (m->vpn[h] && m->vpn[h] != vpn + 1) h = (h + 1) & (m->cap - 1);
+    return h;
+}
+
+/* frame of a virtual page; unseen pages get the next frame (first-touch order) */
+static CACHESIM_INLINE unsigned long long cachesim_translate(unsigned long long a) {
+    CachePageMap* m = &g_cachesim.pages;
+    unsigned long long vpn = a >> CACHESIM_PAGE_BITS;
+    size_t h;
+    if (2 * (m->used + 1) > m->cap) {   /* keep load <= 1/2 */
+        CachePageMap old = *m;
+        size_t i;
+        m->cap = old.cap ? 2 * old.cap : 1024;
+        m->vpn = (unsigned long long*)calloc(m->cap, sizeof(unsigned long long));
+        m->frame = (unsigned long long*)malloc(m->cap * sizeof(unsigned long long));
+        if (!m->vpn || !m->frame) { fprintf(stderr, "cachesim: malloc failed\n"); exit(1); }
+        for (i = 0; i < old.cap; i++)
+            if (old.vpn[i]) {
+                h = cachesim_page_slot(m, old.vpn[i] - 1);
+                m->vpn[h] = old.vpn[i];
+                m->frame[h] = old.frame[i];
+            }
+        free(old.vpn); free(old.frame);
+    }
+    h = cachesim_page_slot(m, vpn);
+    if (!m->vpn[h]) { m->vpn[h] = vpn + 1; m->frame[h] = m->used++; }
+    return (m->frame[h] << CACHESIM_PAGE_BITS) | (a & ((1ULL << CACHESIM_PAGE_BITS) - 1));
+}
+
+/* every cache line overlapped by [p, p+bytes) walks down the hierarchy */
+static CACHESIM_INLINE void cachesim_touch(const void* p, size_t bytes) {
+    unsigned long long a, first, last, line;
+    int i;
+    if (!g_cachesim.ready) cachesim_init();
+    a = (unsigned long long)(size_t)p;
+    first = a / g_cachesim.line;
+    last = (a + (bytes ? bytes : 1) - 1) / g_cachesim.line;
+    for (; first <= last; first++) {
+        line = cachesim_translate(first * g_cachesim.line) / g_cachesim.line;
+        for (i = 0; i < CACHESIM_LEVELS; i++)
+            if (cachesim_level_access(&g_cachesim.level[i], line)) break;
+    }
+}
+
+/* invalidate every level (cold-cache start); counters and page frames are kept */
+static CACHESIM_INLINE void cachesim_flush(void) {
+    int i;
+    if (!g_cachesim.ready) cachesim_init();
+    for (i = 0; i < CACHESIM_LEVELS; i++) {
+        CacheLevel* c = &g_cachesim.level[i];
+        memset(c->tags, 0, c->sets * c->ways * sizeof(unsigned long long));
+        memset(c->stamp, 0, c->sets * c->ways * sizeof(unsigned long long));
+    }
+}
+
+static CACHESIM_INLINE void cachesim_snapshot(CacheStats* s) {
+    int i;
+    if (!g_cachesim.ready) cachesim_init();
+    for (i = 0; i < CACHESIM_LEVELS; i++) {
+        s->accesses[i] = g_cachesim.level[i].accesses;
+        s->misses[i] = g_cachesim.level[i].misses;
+    }
+}
+
+/* per-query line references and misses since *before */
+static CACHESIM_INLINE void cachesim_report(const char* label, const CacheStats* before, long long queries) {
+    CacheStats now;
+    double q = queries > 0 ? (double)queries : 1.0;
+    int i;
+    cachesim_snapshot(&now);
+    printf("  [cache] %-12s refs/query=%7.2f", label,
+        (now.accesses[0] - before->accesses[0]) / q);
+    for (i = 0; i < CACHESIM_LEVELS; i++)
+        printf("  %s miss/query=%7.2f", g_cachesim.level[i].name,
+            (now.misses[i] - before->misses[i]) / q);
+    printf("\n");
+}
+
+#define CACHE_TOUCH(p, bytes) cachesim_touch((const void*)(p), (bytes))
+
+#else
+
+#define CACHE_TOUCH(p, bytes) ((void)0)
+
+#endif /* CACHE_SIM */
+
+#endif /* CACHESIM_H */
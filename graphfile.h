@@ -0,0 +1,277 @@
+/* file: graphfile.h
+ * Versioned binary CSR graph file, shared by Hw6.c and hw7.c.
+ *
+ * Layout (little-endian, every section starts on a 64-byte boundary):
+ *   GraphFileHeader (128 bytes)
+ *   int64_t offsets[n + 1]   neighbors of u are nbrs[offsets[u] .. offsets[u+1])
+ *   int32_t nbrs[m]          m = stored entries (2x edges when undirected)
+ *   int32_t weights[m]       only when GF_WEIGHTED
+ *
+ * gf_open() mmaps the file read-only and points straight into it, so start-up
+ * costs a header check only (section bounds computed without overflow).
+ * When asked to verify it also checks the section CRC32s and walks the lists
+ * (offsets monotone, ids < n, ascending when GF_SORTED), O(n + m).
+ * Without mmap (_WIN32) the file is read into memory instead.
+ */
+#ifndef GRAPHFILE_H
+#define GRAPHFILE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define GF_MAGIC "HWGRAPH"          /* 8 bytes with the terminating NUL */
+#define GF_VERSION 1u
+#define GF_ENDIAN_TAG 0x01020304u
+
+#define GF_UNDIRECTED 1u            /* every edge stored in both lists */
+#define GF_SORTED 2u                /* each neighbor list ascending */
+#define GF_WEIGHTED 4u              /* weights[] section present */
+
+/* 64-bit file positions: long is 32 bits on Windows (and 32-bit POSIX builds) */
+#ifdef _WIN32
+#define gf_ftell(fp) _ftelli64(fp)
+#define gf_fseek(fp, off, whence) _fseeki64(fp, off, whence)
+#else
+#define gf_ftell(fp) ((int64_t)ftello(fp))
+#define gf_fseek(fp, off, whence) fseeko(fp, (off_t)(off), whence)
+#endif
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t endian;                /* GF_ENDIAN_TAG as written by the producer */
+    uint32_t flags;
+    uint32_t reserved;
+    uint64_t n;                     /* vertices */
+    uint64_t m;                     /* entries in nbrs[] */
+    uint64_t offsets_pos;           /* byte positions of the sections */
+    uint64_t nbrs_pos;
+    uint64_t weights_pos;           /* 0 when unweighted */
+    uint64_t file_size;
+    uint32_t offsets_crc;
+    uint32_t nbrs_crc;
+    uint32_t weights_crc;
+    uint32_t header_crc;            /* CRC32 of the header with this field = 0 */
+    uint8_t pad[40];
+} GraphFileHeader;
+
+typedef struct {
+    uint64_t n, m;
+    uint32_t flags;
+    const int64_t* offsets;
+    const int32_t* nbrs;
+    const int32_t* weights;         /* NULL when unweighted */
+    void* base;
+    size_t size;
+    int mapped;                     /* 1 = munmap on close, 0 = free */
+} GraphFileView;
+
+static inline uint32_t gf_crc32(uint32_t crc, const void* data, size_t len) {
+    static uint32_t table[256];
+    static int ready = 0;
+    const uint8_t* p = (const uint8_t*)data;
+    if (!ready) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        ready = 1;
+    }
+    crc = ~crc;
+    while (len--) crc = table[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+static inline uint64_t gf_align64(uint64_t x) { return (x + 63) & ~(uint64_t)63; }
+
+static inline int gf_write_section(FILE* fp, uint64_t pos, const void* data, size_t bytes) {
+    static const uint8_t zeros[64] = { 0 };
+    int64_t cur = gf_ftell(fp);
+    if (cur < 0 || (uint64_t)cur > pos) return -1;
+    if (fwrite(zeros, 1, (size_t)(pos - (uint64_t)cur), fp) != (size_t)(pos - (uint64_t)cur)) return -1;
+    return bytes == 0 || fwrite(data, 1, bytes, fp) == bytes ? 0 : -1;
+}
+
+/* weights may be NULL; returns 0 on success, -1 (with a message) on failure */
+static inline int gf_write(const char* path, uint64_t n, const int64_t* offsets,
+    const int32_t* nbrs, const int32_t* weights, uint32_t flags) {
+    GraphFileHeader h;
+    uint64_t m = (uint64_t)offsets[n];
+    FILE* fp = fopen(path, "wb");
+    if (!fp) { perror(path); return -1; }
+
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, GF_MAGIC, 8);
+    h.version = GF_VERSION;
+    h.endian = GF_ENDIAN_TAG;
+    h.flags = weights ? flags | GF_WEIGHTED : flags & ~GF_WEIGHTED;
+    h.n = n;
+    h.m = m;
+    h.offsets_pos = gf_align64(sizeof(h));
+    h.nbrs_pos = gf_align64(h.offsets_pos + (n + 1) * sizeof(int64_t));
+    h.weights_pos = weights ? gf_align64(h.nbrs_pos + m * sizeof(int32_t)) : 0;
+    h.file_size = weights ? h.weights_pos + m * sizeof(int32_t) : h.nbrs_pos + m * sizeof(int32_t);
+    h.offsets_crc = gf_crc32(0, offsets, (size_t)(n + 1) * sizeof(int64_t));
+    h.nbrs_crc = gf_crc32(0, nbrs, (size_t)m * sizeof(int32_t));
+    h.weights_crc = weights ? gf_crc32(0, weights, (size_t)m * sizeof(int32_t)) : 0;
+    h.header_crc = gf_crc32(0, &h, sizeof(h));
+
+    if (fwrite(&h, sizeof(h), 1, fp) != 1
+        || gf_write_section(fp, h.offsets_pos, offsets, (size_t)(n + 1) * sizeof(int64_t))
+        || gf_write_section(fp, h.nbrs_pos, nbrs, (size_t)m * sizeof(int32_t))
+        || (weights && gf_write_section(fp, h.weights_pos, weights, (size_t)m * sizeof(int32_t)))) {
+        fprintf(stderr, "%s: write failed\n", path);
+        fclose(fp);
+        return -1;
+    }
+    return fclose(fp) == 0 ? 0 : -1;
+}
+
+/* *end = pos + count * elem; -1 when that does not fit in 64 bits */
+static inline int gf_section_end(uint64_t pos, uint64_t count, uint64_t elem, uint64_t* end) {
+    if (count > (UINT64_MAX - pos) / elem) return -1;
+    *end = pos + count * elem;
+    return 0;
+}
+
+/* Header fields that cannot describe an in-bounds, aligned layout */
+static inline int gf_bad_layout(const GraphFileHeader* h, size_t size) {
+    uint64_t offsets_end, nbrs_end, weights_end;
+    if (h->file_size != size || h->n == UINT64_MAX
+        || h->offsets_pos < sizeof(GraphFileHeader) || h->offsets_pos % 8 || h->nbrs_pos % 4
+        || gf_section_end(h->offsets_pos, h->n + 1, sizeof(int64_t), &offsets_end)
+        || gf_section_end(h->nbrs_pos, h->m, sizeof(int32_t), &nbrs_end)
+        || offsets_end > h->nbrs_pos || nbrs_end > h->file_size)
+        return 1;
+    if (!h->weights_pos) return 0;
+    return h->weights_pos % 4 || h->weights_pos < nbrs_end
+        || gf_section_end(h->weights_pos, h->m, sizeof(int32_t), &weights_end)
+        || weights_end > h->file_size;
+}
+
+/* Offsets nondecreasing and within m; every id < n (ascending within a list
+ * when GF_SORTED). Reads every page of both sections, so only on verify.
+ * Returns NULL or what is wrong. */
+static inline const char* gf_bad_lists(const GraphFileView* v) {
+    for (uint64_t u = 0; u < v->n; ++u) {
+        int64_t b = v->offsets[u], e = v->offsets[u + 1];
+        if (e < b || (uint64_t)e > v->m) return "offsets are not monotone";
+        for (int64_t i = b; i < e; ++i) {
+            if (v->nbrs[i] < 0 || (uint64_t)v->nbrs[i] >= v->n) return "neighbor id out of range";
+            if ((v->flags & GF_SORTED) && i > b && v->nbrs[i] < v->nbrs[i - 1])
+                return "list not ascending despite GF_SORTED";
+        }
+    }
+    return NULL;
+}
+
+static inline void gf_close(GraphFileView* v) {
+    if (!v->base) return;
+#ifndef _WIN32
+    if (v->mapped) munmap(v->base, v->size);
+    else
+#endif
+        free(v->base);
+    v->base = NULL;
+}
+
+/* Map path and validate the header; verify != 0 also checks section CRCs
+ * and the lists themselves (gf_bad_lists).
+ * Returns 0 on success, -1 (with a message) on failure. */
+static inline int gf_open(const char* path, GraphFileView* v, int verify) {
+    GraphFileHeader h;
+    uint32_t crc;
+    const char* bad;
+    memset(v, 0, sizeof(*v));
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) { perror(path); if (fd >= 0) close(fd); return -1; }
+    if ((uint64_t)st.st_size > SIZE_MAX) {
+        fprintf(stderr, "%s: file too large to map\n", path);
+        close(fd);
+        return -1;
+    }
+    v->size = (size_t)st.st_size;
+    if (v->size >= sizeof(GraphFileHeader)) {
+        v->base = mmap(NULL, v->size, PROT_READ, MAP_SHARED, fd, 0);
+        if (v->base == MAP_FAILED) v->base = NULL;
+        else v->mapped = 1;
+    }
+    close(fd);
+#else
+    FILE* fp = fopen(path, "rb");
+    if (!fp) { perror(path); return -1; }
+    int64_t end = gf_fseek(fp, 0, SEEK_END) == 0 ? gf_ftell(fp) : -1;
+    if (end < 0 || (uint64_t)end > SIZE_MAX || gf_fseek(fp, 0, SEEK_SET) != 0) {
+        fprintf(stderr, "%s: cannot size file (or too large for memory)\n", path);
+        fclose(fp);
+        return -1;
+    }
+    v->size = (size_t)end;
+    v->base = malloc(v->size ? v->size : 1);
+    if (v->base && fread(v->base, 1, v->size, fp) != v->size) { free(v->base); v->base = NULL; }
+    fclose(fp);
+#endif
+    if (!v->base || v->size < sizeof(GraphFileHeader)) {
+        fprintf(stderr, "%s: not a graph file (too small or unreadable)\n", path);
+        gf_close(v);
+        return -1;
+    }
+
+    memcpy(&h, v->base, sizeof(h));
+    crc = h.header_crc;
+    h.header_crc = 0;
+    if (memcmp(h.magic, GF_MAGIC, 8) != 0 || gf_crc32(0, &h, sizeof(h)) != crc) {
+        fprintf(stderr, "%s: bad magic or header checksum\n", path);
+        gf_close(v);
+        return -1;
+    }
+    if (h.version != GF_VERSION || h.endian != GF_ENDIAN_TAG) {
+        fprintf(stderr, "%s: unsupported version %u or byte order\n", path, h.version);
+        gf_close(v);
+        return -1;
+    }
+    if (gf_bad_layout(&h, v->size)) {
+        fprintf(stderr, "%s: truncated or inconsistent sections\n", path);
+        gf_close(v);
+        return -1;
+    }
+
+    v->n = h.n;
+    v->m = h.m;
+    v->flags = h.flags;
+    v->offsets = (const int64_t*)((const char*)v->base + h.offsets_pos);
+    v->nbrs = (const int32_t*)((const char*)v->base + h.nbrs_pos);
+    v->weights = h.weights_pos ? (const int32_t*)((const char*)v->base + h.weights_pos) : NULL;
+
+    if (verify && (gf_crc32(0, v->offsets, (size_t)(h.n + 1) * sizeof(int64_t)) != h.offsets_crc
+        || gf_crc32(0, v->nbrs, (size_t)h.m * sizeof(int32_t)) != h.nbrs_crc
+        || (v->weights && gf_crc32(0, v->weights, (size_t)h.m * sizeof(int32_t)) != h.weights_crc))) {
+        fprintf(stderr, "%s: section checksum mismatch\n", path);
+        gf_close(v);
+        return -1;
+    }
+    if (v->offsets[0] != 0 || (uint64_t)v->offsets[h.n] != h.m) {
+        fprintf(stderr, "%s: offsets do not span the neighbor array\n", path);
+        gf_close(v);
+        return -1;
+    }
+    if (verify && (bad = gf_bad_lists(v)) != NULL) {
+        fprintf(stderr, "%s: %s\n", path, bad);
+        gf_close(v);
+        return -1;
+    }
+    return 0;
+}
+
+#endif /* GRAPHFILE_H */
@@ -3,7 +3,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-
+#include "cachesim.h"     // -DCACHE_SIM   Ž ޸  ĳ ùķͷ 
 
 #define MAX_NAME_LEN 50
 #define MAX_LINE_LEN 200
@@ -121,6 +121,7 @@ void print_student(const Student* s) {
 int linear_search_unsorted(Student* arr, int n, int key, long long* cmp_count) {
     *cmp_count = 0;
     for (int i = 0; i < n; i++) {
+        CACHE_TOUCH(&arr[i].id, sizeof(int));
         (*cmp_count)++;                   // arr[i].id == key  1ȸ
         if (arr[i].id == key) {
             return i;                     // ã  ε ȯ
@@ -168,6 +169,7 @@ int binary_search_sorted(Student* arr, int n, int key, long long* cmp_count) {
 
     while (left <= right) {
         int mid = (left + right) / 2;
+        CACHE_TOUCH(&arr[mid].id, sizeof(int));
         (*cmp_count)++;                   // key == arr[mid].id 
         if (key == arr[mid].id) {
             return mid;
@@ -364,6 +366,7 @@ AVLNode* avl_insert(AVLNode* node, Student data, long long* cmp_count) {
 AVLNode* avl_search(AVLNode* root, int key, long long* cmp_count) {
     if (!root) return NULL;
 
+    CACHE_TOUCH(&root->data.id, sizeof(int));
     (*cmp_count)++;                           // key == root->data.id 
     if (key == root->data.id) {
         return root;
@@ -371,9 +374,11 @@ AVLNode* avl_search(AVLNode* root, int key, long long* cmp_count) {
 
     (*cmp_count)++;                           // key < root->data.id 
     if (key < root->data.id) {
+        CACHE_TOUCH(&root->left, sizeof(AVLNode*));   // ڽ ʹ id ٸ ĳ   
         return avl_search(root->left, key, cmp_count);
     }
     else {
+        CACHE_TOUCH(&root->right, sizeof(AVLNode*));
         return avl_search(root->right, key, cmp_count);
     }
 }
@@ -540,9 +545,27 @@ int main(void) {
 
             long long cmp_unsorted = 0, cmp_sorted = 0, cmp_avl = 0;
 
+#ifdef CACHE_SIM
+            //   ĳ(cold cache) :   ÷   ʴ´
+            CacheStats cs;
+            printf("\n[ĳ ùķ̼: ˻ 1ȸ]\n");
+            cachesim_flush();
+            cachesim_snapshot(&cs);
+            int pos_unsorted = linear_search_unsorted(unsorted, n_unsorted, key, &cmp_unsorted);
+            cachesim_report("Unsorted", &cs, 1);
+            cachesim_flush();
+            cachesim_snapshot(&cs);
+            int pos_sorted = binary_search_sorted(sorted, n_sorted, key, &cmp_sorted);
+            cachesim_report("Sorted", &cs, 1);
+            cachesim_flush();
+            cachesim_snapshot(&cs);
+            AVLNode* found = avl_search(avl_root, key, &cmp_avl);
+            cachesim_report("AVL", &cs, 1);
+#else
             int pos_unsorted = linear_search_unsorted(unsorted, n_unsorted, key, &cmp_unsorted);
             int pos_sorted = binary_search_sorted(sorted, n_sorted, key, &cmp_sorted);
             AVLNode* found = avl_search(avl_root, key, &cmp_avl);
+#endif
 
             printf("\n[˻ ]\n");
             printf(" 迭 ( Ž):  Ƚ = %lld,  = %s\n",
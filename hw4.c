@@ -1,9 +1,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include "cachesim.h"
 
 #define N 100
 #define MAXV 1000
+#define CACHE_QUERIES 1000   // random queries per structure in -DCACHE_SIM mode
 
 typedef struct Node {
     int key;
@@ -34,6 +36,7 @@ Node* bst_insert(Node* root, int key) {
 /* ----- Search in BST with comparison count ----- */
 int bst_search(Node* root, int key, Counter* c) {
     while (root) {
+        CACHE_TOUCH(root, sizeof(Node));  // node read
         c->comparisons++;                 // compare with root->key
         if (key == root->key) return 1;
         else if (key < root->key) root = root->left;
@@ -53,6 +56,7 @@ void bst_free(Node* root) {
 /* ----- Linear search in array with comparison count ----- */
 int linear_search(int* a, int n, int key, Counter* c) {
     for (int i = 0; i < n; i++) {
+        CACHE_TOUCH(&a[i], sizeof(int));  // element read
         c->comparisons++;                 // compare a[i] with key
         if (a[i] == key) return 1;
     }
@@ -64,6 +68,27 @@ double elapsed_seconds(clock_t start, clock_t end) {
     return (double)(end - start) / CLOCKS_PER_SEC;
 }
 
+#ifdef CACHE_SIM
+/* ----- Simulated cache misses per query, each structure from a cold cache ----- */
+void report_cache_per_query(int* arr, Node* root) {
+    int queries[CACHE_QUERIES];
+    Counter c = { 0 };
+    CacheStats before;
+    for (int q = 0; q < CACHE_QUERIES; q++) queries[q] = rand() % (MAXV + 1);
+
+    printf("\n=== Simulated cache (%d random queries) ===\n", CACHE_QUERIES);
+    cachesim_flush();
+    cachesim_snapshot(&before);
+    for (int q = 0; q < CACHE_QUERIES; q++) linear_search(arr, N, queries[q], &c);
+    cachesim_report("Linear", &before, CACHE_QUERIES);
+
+    cachesim_flush();
+    cachesim_snapshot(&before);
+    for (int q = 0; q < CACHE_QUERIES; q++) bst_search(root, queries[q], &c);
+    cachesim_report("BST", &before, CACHE_QUERIES);
+}
+#endif
+
 int main(void) {
     srand((unsigned)time(NULL));
 
@@ -122,6 +147,10 @@ int main(void) {
     printf("BST Search   : found=%d, comparisons=%lld, time=%.9f s\n",
         bstFound2, bstC2.comparisons, bstTime2);
 
+#ifdef CACHE_SIM
+    report_cache_per_query(arr, root);
+#endif
+
     // Free memory
     bst_free(root);
     return 0;
@@ -1,10 +1,28 @@
 ﻿#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
 #include <time.h>
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "cachesim.h"
 
 #define N 1000
 #define MAXV 10000
 
+/* bulk ops: subtrees lower than this are merged serially (no task spawn) */
+#define AVL_PAR_CUTOFF_HEIGHT 14
+#define BULK_DEFAULT_N 1000000
+
+/* skewed query workloads */
+#define ZIPF_S 1.0            /* Zipf exponent: P(rank r) ~ 1 / r^s */
+#define HOT_FRACTION 0.10     /* hot set = 10% of the keys ... */
+#define HOT_PROB 0.90         /* ... receiving 90% of the queries */
+#define SKEW_DEFAULT_N 1000000
+#define SKEW_DEFAULT_Q 2000000
+
 /*============================
  *  AVL / BST node
  *============================*/
@@ -18,6 +36,7 @@ typedef struct Node {
 /* ---- helpers: không dùng inline để hợp MSVC C89 ---- */
 static int mymax(int a, int b) { return a > b ? a : b; }
 static int height(Node* n) { return n ? n->height : 0; }
+void free_tree(Node* root);
 
 Node* new_node(int key) {
     Node* n = (Node*)malloc(sizeof(Node));
@@ -87,12 +106,251 @@ Node* avl_insert(Node* node, int key) {
     return node;
 }
 
+/*============================
+ *  Join-based bulk operations
+ *  (split/join primitives, then union / intersection / difference
+ *   in O(m log(n/m + 1)) work, forked with OpenMP tasks)
+ *
+ *  All set operations CONSUME both input trees: every node ends up
+ *  either in the result or freed, so callers must not reuse inputs.
+ *============================*/
+static Node* avl_attach(Node* l, Node* k, Node* r) {
+    k->left = l; k->right = r;
+    k->height = 1 + mymax(height(l), height(r));
+    return k;
+}
+
+/* tl is taller than tr by more than one level */
+static Node* avl_join_right(Node* tl, Node* k, Node* tr) {
+    Node* l = tl->left;
+    Node* c = tl->right;
+    Node* t;
+    if (height(c) <= height(tr) + 1) {
+        t = avl_attach(c, k, tr);
+        if (height(t) <= height(l) + 1) return avl_attach(l, tl, t);
+        return rotate_left(avl_attach(l, tl, rotate_right(t)));
+    }
+    t = avl_join_right(c, k, tr);
+    avl_attach(l, tl, t);
+    if (height(t) <= height(l) + 1) return tl;
+    return rotate_left(tl);
+}
+
+/* mirror of avl_join_right: tr is the taller one */
+static Node* avl_join_left(Node* tl, Node* k, Node* tr) {
+    Node* c = tr->left;
+    Node* r = tr->right;
+    Node* t;
+    if (height(c) <= height(tl) + 1) {
+        t = avl_attach(tl, k, c);
+        if (height(t) <= height(r) + 1) return avl_attach(t, tr, r);
+        return rotate_right(avl_attach(rotate_left(t), tr, r));
+    }
+    t = avl_join_left(tl, k, c);
+    avl_attach(t, tr, r);
+    if (height(t) <= height(r) + 1) return tr;
+    return rotate_right(tr);
+}
+
+/* all keys of tl < k->key < all keys of tr */
+Node* avl_join(Node* tl, Node* k, Node* tr) {
+    if (height(tl) > height(tr) + 1) return avl_join_right(tl, k, tr);
+    if (height(tr) > height(tl) + 1) return avl_join_left(tl, k, tr);
+    return avl_attach(tl, k, tr);
+}
+
+/* Split t into keys < key (*lo) and > key (*hi).
+ * Returns the detached node holding key, or NULL if absent. */
+Node* avl_split(Node* t, int key, Node** lo, Node** hi) {
+    Node* l, * r, * m;
+    if (!t) { *lo = *hi = NULL; return NULL; }
+    l = t->left; r = t->right;
+    if (key == t->key) {
+        *lo = l; *hi = r;
+        t->left = t->right = NULL; t->height = 1;
+        return t;
+    }
+    if (key < t->key) {
+        m = avl_split(l, key, lo, &l);
+        *hi = avl_join(l, t, r);
+    }
+    else {
+        m = avl_split(r, key, &r, hi);
+        *lo = avl_join(l, t, r);
+    }
+    return m;
+}
+
+/* Detach the maximum node of t; the remaining tree goes to *rest */
+static Node* avl_split_last(Node* t, Node** rest) {
+    Node* last;
+    if (!t->right) { *rest = t->left; return t; }
+    last = avl_split_last(t->right, rest);
+    *rest = avl_join(t->left, t, *rest);
+    return last;
+}
+
+/* join without a middle key */
+Node* avl_join2(Node* tl, Node* tr) {
+    Node* rest, * k;
+    if (!tl) return tr;
+    k = avl_split_last(tl, &rest);
+    return avl_join(rest, k, tr);
+}
+
+static Node* avl_union_rec(Node* a, Node* b) {
+    Node* la, * ra, * lb, * rb, * dup, * tl, * tr;
+    if (!a) return b;
+    if (!b) return a;
+    lb = b->left; rb = b->right;
+    dup = avl_split(a, b->key, &la, &ra);
+    if (dup) free(dup);
+#pragma omp task shared(tl) if(height(b) >= AVL_PAR_CUTOFF_HEIGHT)
+    tl = avl_union_rec(la, lb);
+    tr = avl_union_rec(ra, rb);
+#pragma omp taskwait
+    return avl_join(tl, b, tr);
+}
+
+static Node* avl_intersect_rec(Node* a, Node* b) {
+    Node* la, * ra, * lb, * rb, * dup, * tl, * tr;
+    if (!a || !b) { free_tree(a); free_tree(b); return NULL; }
+    lb = b->left; rb = b->right;
+    dup = avl_split(a, b->key, &la, &ra);
+#pragma omp task shared(tl) if(height(b) >= AVL_PAR_CUTOFF_HEIGHT)
+    tl = avl_intersect_rec(la, lb);
+    tr = avl_intersect_rec(ra, rb);
+#pragma omp taskwait
+    if (dup) { free(dup); return avl_join(tl, b, tr); }
+    free(b);
+    return avl_join2(tl, tr);
+}
+
+/* a \ b */
+static Node* avl_difference_rec(Node* a, Node* b) {
+    Node* la, * ra, * lb, * rb, * dup, * tl, * tr;
+    if (!a || !b) { free_tree(b); return a; }
+    lb = b->left; rb = b->right;
+    dup = avl_split(a, b->key, &la, &ra);
+    if (dup) free(dup);
+    free(b);
+#pragma omp task shared(tl) if(height(lb) + 1 >= AVL_PAR_CUTOFF_HEIGHT)
+    tl = avl_difference_rec(la, lb);
+    tr = avl_difference_rec(ra, rb);
+#pragma omp taskwait
+    return avl_join2(tl, tr);
+}
+
+/* Public entry points: open one parallel region, recurse from a single task */
+Node* avl_union(Node* a, Node* b) {
+    Node* res = NULL;
+#pragma omp parallel
+#pragma omp single
+    res = avl_union_rec(a, b);
+    return res;
+}
+
+Node* avl_intersection(Node* a, Node* b) {
+    Node* res = NULL;
+#pragma omp parallel
+#pragma omp single
+    res = avl_intersect_rec(a, b);
+    return res;
+}
+
+Node* avl_difference(Node* a, Node* b) {
+    Node* res = NULL;
+#pragma omp parallel
+#pragma omp single
+    res = avl_difference_rec(a, b);
+    return res;
+}
+
+/* O(n) build of a perfectly balanced AVL from strictly increasing keys */
+Node* avl_from_sorted(const int* keys, int lo, int hi) {
+    int mid;
+    Node* n;
+    if (lo > hi) return NULL;
+    mid = lo + (hi - lo) / 2;
+    n = new_node(keys[mid]);
+    return avl_attach(avl_from_sorted(keys, lo, mid - 1), n,
+        avl_from_sorted(keys, mid + 1, hi));
+}
+
+/*============================
+ *  Splay tree (self-adjusting; reuses Node, height ignored)
+ *============================*/
+/* Top-down splay (Sleator-Tarjan). Brings key, or the last node on its
+ * search path, to the root. *cmp counts every node whose key is compared. */
+Node* splay(Node* t, int key, long long* cmp) {
+    Node head, * l, * r, * y;
+    if (!t) return t;
+    head.left = head.right = NULL;
+    l = r = &head;
+    for (;;) {
+        CACHE_TOUCH(t, sizeof(Node));
+        (*cmp)++;                 /* compare t->key with key */
+        if (key < t->key) {
+            if (!t->left) break;
+            CACHE_TOUCH(t->left, sizeof(Node));
+            (*cmp)++;             /* compare t->left->key with key */
+            if (key < t->left->key) { /* zig-zig: rotate right */
+                y = t->left; t->left = y->right; y->right = t; t = y;
+                if (!t->left) break;
+            }
+            else if (key == t->left->key) { /* one more link, no recount */
+                r->left = t; r = t; t = t->left;
+                break;
+            }
+            r->left = t; r = t; t = t->left;
+        }
+        else if (key > t->key) {
+            if (!t->right) break;
+            CACHE_TOUCH(t->right, sizeof(Node));
+            (*cmp)++;
+            if (key > t->right->key) { /* zag-zag: rotate left */
+                y = t->right; t->right = y->left; y->left = t; t = y;
+                if (!t->right) break;
+            }
+            else if (key == t->right->key) {
+                l->right = t; l = t; t = t->right;
+                break;
+            }
+            l->right = t; l = t; t = t->right;
+        }
+        else break;
+    }
+    l->right = t->left; r->left = t->right;
+    t->left = head.right; t->right = head.left;
+    return t;
+}
+
+Node* splay_insert(Node* root, int key) {
+    Node* n;
+    long long dummy = 0;
+    if (!root) return new_node(key);
+    root = splay(root, key, &dummy);
+    if (key == root->key) return root; /* dup */
+    n = new_node(key);
+    if (key < root->key) { n->right = root; n->left = root->left; root->left = NULL; }
+    else { n->left = root; n->right = root->right; root->right = NULL; }
+    return n;
+}
+
+/* search + splay; returns comparisons, *root is restructured */
+int splay_search_count(Node** root, int x) {
+    long long cnt = 0;
+    *root = splay(*root, x, &cnt);
+    return (int)cnt;
+}
+
 /*============================
  *  Search counting (== comparisons)
  *============================*/
 int array_linear_search_count(const int* arr, int x) {
     int i, cnt = 0;
     for (i = 0; i < N; i++) {
+        CACHE_TOUCH(&arr[i], sizeof(int));
         cnt++;                    /* compare arr[i] == x */
         if (arr[i] == x) return cnt;
     }
@@ -102,6 +360,7 @@ int array_linear_search_count(const int* arr, int x) {
 int bst_search_count(Node* root, int x) {
     int cnt = 0;
     while (root) {
+        CACHE_TOUCH(root, sizeof(Node));
         cnt++;                    /* compare root->key == x */
         if (x == root->key) return cnt;
         if (x < root->key) root = root->left;
@@ -146,65 +405,375 @@ void make_dataset4_formula(int out[N]) {
 }
 
 void build_structures_from_data(const int data_in[N], int array_out[N],
-    Node** bst_root, Node** avl_root) {
+    Node** bst_root, Node** avl_root, Node** splay_root) {
     int i;
     for (i = 0; i < N; i++) array_out[i] = data_in[i];
-    *bst_root = NULL; *avl_root = NULL;
+    *bst_root = NULL; *avl_root = NULL; *splay_root = NULL;
     for (i = 0; i < N; i++) {
         *bst_root = bst_insert(*bst_root, data_in[i]);
         *avl_root = avl_insert(*avl_root, data_in[i]);
+        *splay_root = splay_insert(*splay_root, data_in[i]);
+    }
+}
+
+/*============================
+ *  Query generators (uniform / Zipf / hot-set)
+ *============================*/
+typedef enum { QUERY_UNIFORM, QUERY_ZIPF, QUERY_HOTSET } QueryDist;
+
+typedef struct {
+    QueryDist dist;
+    int* keys;        /* popularity order: keys[0] is the hottest */
+    int nkeys;
+    double* cdf;      /* QUERY_ZIPF: cumulative probability per rank */
+    int hot_count;    /* QUERY_HOTSET: keys[0..hot_count-1] are hot */
+} QueryGen;
+
+static double zipf_exponent = ZIPF_S;
+
+/* splitmix64 stream of its own, so skewed workloads never consume rand()
+ * and the uniform experiments keep exactly the baseline sequence */
+static uint64_t query_rng_state = 20251020;
+
+static uint64_t query_rng_next(void) {
+    uint64_t z = (query_rng_state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/* uniform in [0,1) from the top 53 bits */
+static double rand_unit(void) {
+    return (double)(query_rng_next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static int rand_index(int n) {
+    int i = (int)(rand_unit() * n);
+    return i < n ? i : n - 1;
+}
+
+/* Popularity ranks are a random permutation of the keys, so hotness is
+ * independent of insertion order (and of position in the tree). */
+void query_gen_init(QueryGen* g, QueryDist dist, const int* keys, int nkeys) {
+    int i;
+    double sum = 0.0;
+    g->dist = dist; g->nkeys = nkeys; g->cdf = NULL; g->hot_count = 0;
+    g->keys = (int*)malloc((size_t)nkeys * sizeof(int));
+    if (!g->keys) { fprintf(stderr, "malloc failed\n"); exit(1); }
+    for (i = 0; i < nkeys; i++) g->keys[i] = keys[i];
+    for (i = nkeys - 1; i > 0; i--) {
+        int j = rand_index(i + 1), t = g->keys[i];
+        g->keys[i] = g->keys[j]; g->keys[j] = t;
+    }
+    if (dist == QUERY_ZIPF) {
+        g->cdf = (double*)malloc((size_t)nkeys * sizeof(double));
+        if (!g->cdf) { fprintf(stderr, "malloc failed\n"); exit(1); }
+        for (i = 0; i < nkeys; i++) { sum += 1.0 / pow(i + 1.0, zipf_exponent); g->cdf[i] = sum; }
+        for (i = 0; i < nkeys; i++) g->cdf[i] /= sum;
     }
+    else if (dist == QUERY_HOTSET) {
+        g->hot_count = (int)(nkeys * HOT_FRACTION);
+        if (g->hot_count < 1) g->hot_count = 1;
+    }
+}
+
+void query_gen_free(QueryGen* g) {
+    free(g->keys); free(g->cdf);
+    g->keys = NULL; g->cdf = NULL;
 }
 
-/* Run 1000 queries and print averages */
+int query_gen_next(const QueryGen* g) {
+    int lo, hi, mid;
+    double u;
+    switch (g->dist) {
+    case QUERY_ZIPF:
+        u = rand_unit(); lo = 0; hi = g->nkeys - 1;
+        while (lo < hi) { /* first rank with cdf >= u */
+            mid = lo + (hi - lo) / 2;
+            if (g->cdf[mid] < u) lo = mid + 1; else hi = mid;
+        }
+        return g->keys[lo];
+    case QUERY_HOTSET:
+        if (rand_unit() < HOT_PROB || g->hot_count == g->nkeys)
+            return g->keys[rand_index(g->hot_count)];
+        return g->keys[g->hot_count + rand_index(g->nkeys - g->hot_count)];
+    default:
+        return rand_index(MAXV + 1); /* 0..10000 */
+    }
+}
+
+/* Run 1000 queries and print averages (gen == NULL: uniform over 0..MAXV) */
 void run_queries_and_report(const int array_data[N], Node* bst_root, Node* avl_root,
-    const char* dataset_name) {
-    long long sum_array = 0, sum_bst = 0, sum_avl = 0;
+    Node** splay_root, const QueryGen* gen, const char* dataset_name) {
+    long long sum_array = 0, sum_bst = 0, sum_avl = 0, sum_splay = 0;
     int q;
-    for (q = 0; q < N; q++) {
-        int x = rand() % (MAXV + 1); /* 0..10000 */
-        sum_array += array_linear_search_count(array_data, x);
-        sum_bst += bst_search_count(bst_root, x);
-        sum_avl += bst_search_count(avl_root, x); /* same counting logic */
-    }
+    int xs[N];
+#ifdef CACHE_SIM
+    CacheStats before;
+#define CACHE_PHASE_BEGIN() (cachesim_flush(), cachesim_snapshot(&before))
+#define CACHE_PHASE_END(label) cachesim_report(label, &before, N)
+#else
+#define CACHE_PHASE_BEGIN() ((void)0)
+#define CACHE_PHASE_END(label) ((void)0)
+#endif
+    for (q = 0; q < N; q++)
+        xs[q] = gen ? query_gen_next(gen) : rand() % (MAXV + 1); /* 0..10000 */
+    /* one structure at a time, so simulated caches are not shared */
+    CACHE_PHASE_BEGIN();
+    for (q = 0; q < N; q++) sum_array += array_linear_search_count(array_data, xs[q]);
+    CACHE_PHASE_END("Array");
+    CACHE_PHASE_BEGIN();
+    for (q = 0; q < N; q++) sum_bst += bst_search_count(bst_root, xs[q]);
+    CACHE_PHASE_END("BST");
+    CACHE_PHASE_BEGIN();
+    for (q = 0; q < N; q++) sum_avl += bst_search_count(avl_root, xs[q]); /* same counting logic */
+    CACHE_PHASE_END("AVL");
+    CACHE_PHASE_BEGIN();
+    for (q = 0; q < N; q++) sum_splay += splay_search_count(splay_root, xs[q]);
+    CACHE_PHASE_END("Splay");
+#undef CACHE_PHASE_BEGIN
+#undef CACHE_PHASE_END
     printf("Array: 데이터 %s에서 평균 %.2f회 탐색\n", dataset_name, (double)sum_array / N);
     printf("BST:   데이터 %s에서 평균 %.2f회 탐색\n", dataset_name, (double)sum_bst / N);
     printf("AVL:   데이터 %s에서 평균 %.2f회 탐색\n", dataset_name, (double)sum_avl / N);
+    printf("Splay: 데이터 %s에서 평균 %.2f회 탐색\n", dataset_name, (double)sum_splay / N);
+}
+
+/* Zipf and hot-set queries over the dataset's own keys */
+void run_skewed_queries_and_report(const int array_data[N], Node* bst_root, Node* avl_root,
+    Node** splay_root, const char* dataset_name) {
+    QueryGen g;
+    char label[64];
+
+    query_gen_init(&g, QUERY_ZIPF, array_data, N);
+    sprintf(label, "%s zipf", dataset_name);
+    run_queries_and_report(array_data, bst_root, avl_root, splay_root, &g, label);
+    query_gen_free(&g);
+
+    query_gen_init(&g, QUERY_HOTSET, array_data, N);
+    sprintf(label, "%s hot-set", dataset_name);
+    run_queries_and_report(array_data, bst_root, avl_root, splay_root, &g, label);
+    query_gen_free(&g);
+}
+
+/*============================
+ *  Bulk-operation benchmark
+ *============================*/
+static double wall_seconds(void) {
+#ifdef _OPENMP
+    return omp_get_wtime();
+#else
+    return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+/* returns the height if root is a valid AVL with keys in (lo, hi), else -1 */
+static int avl_validate(Node* root, long long lo, long long hi) {
+    int hl, hr;
+    if (!root) return 0;
+    if (root->key <= lo || root->key >= hi) return -1;
+    hl = avl_validate(root->left, lo, root->key);
+    hr = avl_validate(root->right, root->key, hi);
+    if (hl < 0 || hr < 0 || hl - hr > 1 || hr - hl > 1) return -1;
+    if (root->height != 1 + mymax(hl, hr)) return -1;
+    return root->height;
+}
+
+static long long tree_size(Node* root) {
+    if (!root) return 0;
+    return 1 + tree_size(root->left) + tree_size(root->right);
+}
+
+/* strictly increasing random keys, average gap 2 */
+static int* make_sorted_keys(int n) {
+    int i, v = 0;
+    int* k = (int*)malloc((size_t)n * sizeof(int));
+    if (!k) { fprintf(stderr, "malloc failed\n"); exit(1); }
+    for (i = 0; i < n; i++) { v += 1 + rand() % 3; k[i] = v; }
+    return k;
 }
 
-int main(void) {
+/* expected |A u B|, |A n B|, |A \ B| by linear merge */
+static void merge_counts(const int* a, int n, const int* b, int m,
+    long long* uni, long long* inter, long long* diff) {
+    int i = 0, j = 0;
+    *uni = *inter = *diff = 0;
+    while (i < n && j < m) {
+        (*uni)++;
+        if (a[i] == b[j]) { (*inter)++; i++; j++; }
+        else if (a[i] < b[j]) { (*diff)++; i++; }
+        else j++;
+    }
+    *uni += (n - i) + (m - j);
+    *diff += n - i;
+}
+
+static void report_bulk(const char* op, Node* res, long long expect, double sec) {
+    int ok = avl_validate(res, -2147483649LL, 2147483648LL) >= 0 && tree_size(res) == expect;
+    printf("%-13s size=%lld  time=%.3f s  %s\n", op, tree_size(res), sec, ok ? "OK" : "MISMATCH");
+}
+
+void run_bulk_benchmark(int n, int m) {
+    int i, threads = 1;
+    int* a = make_sorted_keys(n);
+    int* b = make_sorted_keys(m);
+    long long uni, inter, diff;
+    Node* ta, * tb, * res;
+    double t0;
+
+#ifdef _OPENMP
+    threads = omp_get_max_threads();
+#endif
+    merge_counts(a, n, b, m, &uni, &inter, &diff);
+    printf("Bulk AVL ops: |A|=%d |B|=%d threads=%d\n", n, m, threads);
+
+    /* baseline: insert every key of B into A one at a time */
+    ta = avl_from_sorted(a, 0, n - 1);
+    t0 = wall_seconds();
+    for (i = 0; i < m; i++) ta = avl_insert(ta, b[i]);
+    report_bulk("insert-loop", ta, uni, wall_seconds() - t0);
+    free_tree(ta);
+
+    ta = avl_from_sorted(a, 0, n - 1); tb = avl_from_sorted(b, 0, m - 1);
+    t0 = wall_seconds();
+    res = avl_union(ta, tb);
+    report_bulk("union", res, uni, wall_seconds() - t0);
+    free_tree(res);
+
+    ta = avl_from_sorted(a, 0, n - 1); tb = avl_from_sorted(b, 0, m - 1);
+    t0 = wall_seconds();
+    res = avl_intersection(ta, tb);
+    report_bulk("intersection", res, inter, wall_seconds() - t0);
+    free_tree(res);
+
+    ta = avl_from_sorted(a, 0, n - 1); tb = avl_from_sorted(b, 0, m - 1);
+    t0 = wall_seconds();
+    res = avl_difference(ta, tb);
+    report_bulk("difference", res, diff, wall_seconds() - t0);
+    free_tree(res);
+
+    free(a); free(b);
+}
+
+/*============================
+ *  Skewed-workload benchmark (comparisons + wall time)
+ *============================*/
+static void time_tree_queries(const char* name, Node* root, Node** splay_root,
+    const int* qs, int q) {
+    long long cmp = 0;
+    double t0, sec;
+    int i;
+#ifdef CACHE_SIM
+    CacheStats before;
+    cachesim_flush();
+    cachesim_snapshot(&before);
+#endif
+    t0 = wall_seconds();
+    if (splay_root) for (i = 0; i < q; i++) cmp += splay_search_count(splay_root, qs[i]);
+    else for (i = 0; i < q; i++) cmp += bst_search_count(root, qs[i]);
+    sec = wall_seconds() - t0;
+    printf("  %-6s avg comparisons=%6.2f  time=%7.1f ns/query\n",
+        name, (double)cmp / q, sec * 1e9 / q);
+#ifdef CACHE_SIM
+    cachesim_report(name, &before, q);
+#endif
+}
+
+void run_skew_benchmark(int n, int q) {
+    static const char* names[] = { "uniform", "zipf", "hot-set" };
+    int* keys = make_sorted_keys(n);
+    int* order = (int*)malloc((size_t)n * sizeof(int));
+    int* qs = (int*)malloc((size_t)q * sizeof(int));
+    Node* bst = NULL, * avl, * spl;
+    QueryGen g;
+    int i, d;
+
+    if (!order || !qs) { fprintf(stderr, "malloc failed\n"); exit(1); }
+    /* random insertion order keeps the plain BST at O(log n) expected depth */
+    for (i = 0; i < n; i++) order[i] = keys[i];
+    for (i = n - 1; i > 0; i--) {
+        int j = rand_index(i + 1), t = order[i];
+        order[i] = order[j]; order[j] = t;
+    }
+    for (i = 0; i < n; i++) bst = bst_insert(bst, order[i]);
+    avl = avl_from_sorted(keys, 0, n - 1);
+
+    printf("Skewed queries: n=%d keys, %d queries, zipf s=%.2f, hot set %.0f%%/%.0f%%\n",
+        n, q, zipf_exponent, HOT_FRACTION * 100, HOT_PROB * 100);
+    for (d = QUERY_UNIFORM; d <= QUERY_HOTSET; d++) {
+        query_gen_init(&g, (QueryDist)d, keys, n);
+        /* uniform here means uniform over the stored keys (all hits) */
+        for (i = 0; i < q; i++)
+            qs[i] = d == QUERY_UNIFORM ? g.keys[rand_index(n)] : query_gen_next(&g);
+        query_gen_free(&g);
+
+        spl = NULL;
+        for (i = 0; i < n; i++) spl = splay_insert(spl, order[i]);
+        printf("[%s]\n", names[d]);
+        time_tree_queries("BST", bst, NULL, qs, q);
+        time_tree_queries("AVL", avl, NULL, qs, q);
+        time_tree_queries("Splay", NULL, &spl, qs, q);
+        free_tree(spl);
+    }
+    free_tree(bst); free_tree(avl);
+    free(keys); free(order); free(qs);
+}
+
+/* usage: hw5            -> comparison-count experiment on datasets (1)..(4)
+ *        hw5 bulk [n] [m] -> union/intersection/difference of two AVL trees
+ *        hw5 skew [n] [q] [s] -> BST/AVL/splay under uniform, Zipf(s), hot-set queries */
+int main(int argc, char* argv[]) {
     int i;
     int arr[N];
     int data[4][N];
     Node* bst = NULL;
     Node* avl = NULL;
+    Node* spl = NULL;
 
     /* đặt seed sau KHỞI TẠO biến để hợp C89 */
     srand(20251020); /* hoặc: srand((unsigned)time(NULL)); */
 
+    if (argc >= 2 && strcmp(argv[1], "bulk") == 0) {
+        int n = argc >= 3 ? atoi(argv[2]) : BULK_DEFAULT_N;
+        int m = argc >= 4 ? atoi(argv[3]) : n;
+        run_bulk_benchmark(n, m);
+        return 0;
+    }
+    if (argc >= 2 && strcmp(argv[1], "skew") == 0) {
+        int n = argc >= 3 ? atoi(argv[2]) : SKEW_DEFAULT_N;
+        int q = argc >= 4 ? atoi(argv[3]) : SKEW_DEFAULT_Q;
+        if (argc >= 5) zipf_exponent = atof(argv[4]);
+        run_skew_benchmark(n, q);
+        return 0;
+    }
+
     /* (1) unique random */
     make_dataset1_unique_random(data[0]);
-    build_structures_from_data(data[0], arr, &bst, &avl);
-    run_queries_and_report(arr, bst, avl, "(1)");
-    free_tree(bst); free_tree(avl); bst = avl = NULL;
+    build_structures_from_data(data[0], arr, &bst, &avl, &spl);
+    run_queries_and_report(arr, bst, avl, &spl, NULL, "(1)");
+    run_skewed_queries_and_report(arr, bst, avl, &spl, "(1)");
+    free_tree(bst); free_tree(avl); free_tree(spl); bst = avl = spl = NULL;
 
     /* (2) sorted increasing 0..999 */
     make_dataset2_sorted_inc(data[1]);
-    build_structures_from_data(data[1], arr, &bst, &avl);
-    run_queries_and_report(arr, bst, avl, "(2)");
-    free_tree(bst); free_tree(avl); bst = avl = NULL;
+    build_structures_from_data(data[1], arr, &bst, &avl, &spl);
+    run_queries_and_report(arr, bst, avl, &spl, NULL, "(2)");
+    run_skewed_queries_and_report(arr, bst, avl, &spl, "(2)");
+    free_tree(bst); free_tree(avl); free_tree(spl); bst = avl = spl = NULL;
 
     /* (3) sorted decreasing 999..0 */
     make_dataset3_sorted_dec(data[2]);
-    build_structures_from_data(data[2], arr, &bst, &avl);
-    run_queries_and_report(arr, bst, avl, "(3)");
-    free_tree(bst); free_tree(avl); bst = avl = NULL;
+    build_structures_from_data(data[2], arr, &bst, &avl, &spl);
+    run_queries_and_report(arr, bst, avl, &spl, NULL, "(3)");
+    run_skewed_queries_and_report(arr, bst, avl, &spl, "(3)");
+    free_tree(bst); free_tree(avl); free_tree(spl); bst = avl = spl = NULL;
 
     /* (4) value[i] = i * (i % 2 + 2) */
     make_dataset4_formula(data[3]);
-    build_structures_from_data(data[3], arr, &bst, &avl);
-    run_queries_and_report(arr, bst, avl, "(4)");
-    free_tree(bst); free_tree(avl); bst = avl = NULL;
+    build_structures_from_data(data[3], arr, &bst, &avl, &spl);
+    run_queries_and_report(arr, bst, avl, &spl, NULL, "(4)");
+    run_skewed_queries_and_report(arr, bst, avl, &spl, "(4)");
+    free_tree(bst); free_tree(avl); free_tree(spl); bst = avl = spl = NULL;
 
     return 0;
 }
@@ -1,10 +1,30 @@
+#define _POSIX_C_SOURCE 200809L // mmap in graphfile.h
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 #include <time.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "graphfile.h"
 
 #define N 10        // number of vertices
 #define M 20        // number of edges (undirected)
 #define INF 1e9
+#define BFS_ALPHA 14  // top-down -> bottom-up when frontier edges > unexplored edges / ALPHA
+#define BFS_BETA 24   // bottom-up -> top-down when the frontier shrinks below n / BETA
+#define MSBFS_WORDS 4 // 64-bit words per vertex mask: 256 sources per pass
+#define HOPS_FAR 255  // uint8 distance for unreachable (or >= 255 hops)
+#define PBFS_CHUNKS_PER_THREAD 8 // frontier split finer than threads for load balance
+#define LM_FAR 0xFFFF // uint16 oracle distance for unreachable
+#define PLL_MAX_ENTRIES (1LL << 28) // label entries before PLL gives up (~1.5 GB)
+#define WDIST_INF INT64_MAX // weighted distance of unreached vertices
+#define CC_NEIGHBOR_ROUNDS 2 // Afforest: neighbors per vertex linked before sampling
+#define CC_SAMPLES 1024      // Afforest: vertices sampled to find the giant component
 
 // Adjacency matrix, adj[u][v] = 1 if edge (u, v) exists
 int adj[N][N];
@@ -87,7 +107,2307 @@ void print_path(int s, int t, int prev[N]) {
     printf("\n");
 }
 
+/* ---------- CSR graphs (runtime size) ---------- */
+
+// Undirected graph: neighbors of u are nbrs[offsets[u] .. offsets[u+1]), ascending
+typedef struct {
+    int n;
+    long long m;            // stored arcs = 2 * undirected edges
+    int64_t* offsets;       // size n+1
+    int* nbrs;
+    int* weights;           // weight of arc nbrs[e] (symmetric), NULL when unweighted
+    GraphFileView* file;    // non-NULL: offsets/nbrs/weights point into a mapped graph file
+} Graph;
+
+double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// splitmix64: rand() is too slow and too narrow for millions of vertices
+uint64_t rng_next(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+int cmp_int(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+int graph_degree(const Graph* g, int u) { return (int)(g->offsets[u + 1] - g->offsets[u]); }
+
+void graph_free(Graph* g) {
+    if (!g) return;
+    if (g->file) {
+        gf_close(g->file);
+        free(g->file);
+    }
+    else {
+        free(g->offsets);
+        free(g->nbrs);
+        free(g->weights);
+    }
+    free(g);
+}
+
+// Edge list (eu[i], ev[i]) -> CSR; self-loops and duplicates are dropped
+Graph* graph_from_edges(int n, const int* eu, const int* ev, long long E) {
+    Graph* g = (Graph*)malloc(sizeof(Graph));
+    g->n = n;
+    g->weights = NULL;
+    g->file = NULL;
+    g->offsets = (int64_t*)calloc((size_t)n + 1, sizeof(int64_t));
+    for (long long i = 0; i < E; ++i)
+        if (eu[i] != ev[i]) { g->offsets[eu[i] + 1]++; g->offsets[ev[i] + 1]++; }
+    for (int u = 0; u < n; ++u) g->offsets[u + 1] += g->offsets[u];
+    g->nbrs = (int*)malloc((size_t)g->offsets[n] * sizeof(int) + sizeof(int));
+    int64_t* cursor = (int64_t*)malloc((size_t)n * sizeof(int64_t) + sizeof(int64_t));
+    memcpy(cursor, g->offsets, (size_t)n * sizeof(int64_t));
+    for (long long i = 0; i < E; ++i) {
+        if (eu[i] == ev[i]) continue;
+        g->nbrs[cursor[eu[i]]++] = ev[i];
+        g->nbrs[cursor[ev[i]]++] = eu[i];
+    }
+    free(cursor);
+    // sort + unique each list, packing the lists down as we go
+    int64_t k = 0, start = 0;
+    for (int u = 0; u < n; ++u) {
+        int64_t end = g->offsets[u + 1];
+        qsort(g->nbrs + start, (size_t)(end - start), sizeof(int), cmp_int);
+        g->offsets[u] = k;
+        for (int64_t i = start; i < end; ++i)
+            if (i == start || g->nbrs[i] != g->nbrs[i - 1]) g->nbrs[k++] = g->nbrs[i];
+        start = end;
+    }
+    g->offsets[n] = k;
+    g->m = k;
+    return g;
+}
+
+// E random endpoint pairs (duplicates and self-loops dropped afterwards)
+Graph* graph_random(int n, long long E, uint64_t seed) {
+    int* eu = (int*)malloc((size_t)E * sizeof(int) + sizeof(int));
+    int* ev = (int*)malloc((size_t)E * sizeof(int) + sizeof(int));
+    for (long long i = 0; i < E; ++i) {
+        eu[i] = (int)(rng_next(&seed) % (uint64_t)n);
+        ev[i] = (int)(rng_next(&seed) % (uint64_t)n);
+    }
+    Graph* g = graph_from_edges(n, eu, ev, E);
+    free(eu);
+    free(ev);
+    return g;
+}
+
+// side x side 4-neighbor grid: large diameter, like a road network
+Graph* graph_grid(int side) {
+    long long E = 2LL * side * (side - 1), k = 0;
+    int* eu = (int*)malloc((size_t)E * sizeof(int) + sizeof(int));
+    int* ev = (int*)malloc((size_t)E * sizeof(int) + sizeof(int));
+    for (int y = 0; y < side; ++y)
+        for (int x = 0; x < side; ++x) {
+            if (x + 1 < side) { eu[k] = y * side + x; ev[k++] = y * side + x + 1; }
+            if (y + 1 < side) { eu[k] = y * side + x; ev[k++] = (y + 1) * side + x; }
+        }
+    Graph* g = graph_from_edges(side * side, eu, ev, E);
+    free(eu);
+    free(ev);
+    return g;
+}
+
+// The fixed adj[N][N] demo graph as CSR
+Graph* graph_from_matrix(void) {
+    int eu[N * N], ev[N * N];
+    long long E = 0;
+    for (int i = 0; i < N; ++i)
+        for (int j = i + 1; j < N; ++j)
+            if (adj[i][j]) { eu[E] = i; ev[E++] = j; }
+    return graph_from_edges(N, eu, ev, E);
+}
+
+// Binary graph file written by Hw6 (convert / sample ... out.bin), mapped read-only
+Graph* graph_load(const char* path) {
+    GraphFileView* v = (GraphFileView*)malloc(sizeof(GraphFileView));
+    if (gf_open(path, v, 0) != 0) { free(v); return NULL; }
+    if (!(v->flags & GF_SORTED) || v->n > (uint64_t)INT32_MAX - 1) {
+        fprintf(stderr, "%s: need sorted neighbor lists and n < 2^31\n", path);
+        gf_close(v);
+        free(v);
+        return NULL;
+    }
+    Graph* g = (Graph*)malloc(sizeof(Graph));
+    g->n = (int)v->n;
+    g->m = (long long)v->m;
+    g->offsets = (int64_t*)v->offsets;
+    g->nbrs = (int*)v->nbrs;
+    g->weights = (int*)v->weights;
+    g->file = v;
+    return g;
+}
+
+// Graph argument forms: "n m" (random), "grid side", or "file.bin".
+// *used receives the number of arguments consumed. Sizes that cannot make
+// a graph (n < 1, m < 0, side outside [1, 46340]) print a usage line and give NULL.
+Graph* graph_from_args(int argc, char* argv[], int* used) {
+    static const char* usage = "graph: \"n m\" (n >= 1, m >= 0), \"grid side\" (1 <= side <= 46340) or file.bin\n";
+    if (argc >= 2 && strcmp(argv[0], "grid") == 0) {
+        long side = atol(argv[1]);
+        *used = 2;
+        if (side < 1 || side > 46340) { fprintf(stderr, "%s", usage); return NULL; }   // side^2 fits an int
+        return graph_grid((int)side);
+    }
+    if (argc >= 2 && ((argv[0][0] >= '0' && argv[0][0] <= '9') || argv[0][0] == '-')) {
+        int n = atoi(argv[0]);
+        long long E = atoll(argv[1]);
+        *used = 2;
+        if (n < 1 || E < 0) { fprintf(stderr, "%s", usage); return NULL; }
+        return graph_random(n, E, (uint64_t)time(NULL));
+    }
+    *used = 1;
+    return argc >= 1 ? graph_load(argv[0]) : NULL;
+}
+
+/* ---------- Direction-optimizing BFS ---------- */
+
+typedef struct {
+    int levels;
+    int td_steps, bu_steps;
+    long long edges_checked;
+} BfsStats;
+
+// BFS on CSR. Top-down steps expand the frontier queue; once a growing
+// frontier's edges exceed the unexplored edges / BFS_ALPHA (and direction_opt is set),
+// bottom-up steps let every unvisited vertex look for any parent in the
+// frontier bitmap instead, until the frontier shrinks below n / BFS_BETA.
+// dist[v] = (int)INF and prev[v] = -1 for unreachable v, as in bfs().
+// Returns the number of reached vertices.
+int bfs_csr(const Graph* g, int s, int* dist, int* prev, int direction_opt, BfsStats* st) {
+    int n = g->n;
+    size_t words = ((size_t)n + 63) / 64;
+    int* frontier = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int* next = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    uint64_t* bits = (uint64_t*)calloc(words + 1, sizeof(uint64_t));
+    BfsStats local = { 0 };
+    if (!st) st = &local;
+    memset(st, 0, sizeof(*st));
+
+    for (int i = 0; i < n; ++i) {
+        dist[i] = (int)INF;
+        prev[i] = -1;
+    }
+    dist[s] = 0;
+    frontier[0] = s;
+    int nf = 1, reached = 1, bottom_up = 0;
+    long long m_frontier = graph_degree(g, s), m_unexplored = g->m - m_frontier;
+
+    for (int level = 0; nf > 0; ++level) {
+        int nn = 0;
+        if (bottom_up) {
+            memset(bits, 0, words * sizeof(uint64_t));
+            for (int i = 0; i < nf; ++i) bits[frontier[i] / 64] |= 1ULL << (frontier[i] % 64);
+            for (int v = 0; v < n; ++v) {
+                if (dist[v] != (int)INF) continue;
+                for (int64_t i = g->offsets[v]; i < g->offsets[v + 1]; ++i) {
+                    int u = g->nbrs[i];
+                    st->edges_checked++;
+                    if (bits[u / 64] >> (u % 64) & 1) {
+                        dist[v] = level + 1;
+                        prev[v] = u;
+                        next[nn++] = v;
+                        break;
+                    }
+                }
+            }
+            st->bu_steps++;
+        }
+        else {
+            for (int i = 0; i < nf; ++i) {
+                int u = frontier[i];
+                for (int64_t e = g->offsets[u]; e < g->offsets[u + 1]; ++e) {
+                    int v = g->nbrs[e];
+                    st->edges_checked++;
+                    if (dist[v] == (int)INF) {
+                        dist[v] = level + 1;
+                        prev[v] = u;
+                        next[nn++] = v;
+                    }
+                }
+            }
+            st->td_steps++;
+        }
+
+        m_frontier = 0;
+        for (int i = 0; i < nn; ++i) m_frontier += graph_degree(g, next[i]);
+        m_unexplored -= m_frontier;
+        if (direction_opt) {
+            if (!bottom_up) bottom_up = nn > nf && m_frontier > m_unexplored / BFS_ALPHA;
+            else bottom_up = !(nn < nf && nn < n / BFS_BETA);
+        }
+        int* t = frontier; frontier = next; next = t;
+        nf = nn;
+        reached += nn;
+        if (nn) st->levels = level + 1;
+    }
+    free(frontier);
+    free(next);
+    free(bits);
+    return reached;
+}
+
+// Top-down only vs direction-optimizing BFS from random sources; edge
+// rates count the undirected edges of the reached component (TEPS)
+int run_bfs_benchmark(const Graph* g, int sources) {
+    int n = g->n;
+    int* dist = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int* prev = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int* dist2 = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    uint64_t seed = (uint64_t)time(NULL);
+    double t_td = 0, t_do = 0;
+    long long teps_edges = 0, checked_td = 0, checked_do = 0;
+    int same = 1, done = 0;
+
+    printf("BFS: n=%d, edges=%lld, %d sources\n", n, g->m / 2, sources);
+    for (int k = 0; k < sources * 100 && done < sources; ++k) {
+        int s = (int)(rng_next(&seed) % (uint64_t)n);
+        if (graph_degree(g, s) == 0) continue;
+        BfsStats st;
+        double t0 = now_seconds();
+        int reached = bfs_csr(g, s, dist, prev, 0, &st);
+        t_td += now_seconds() - t0;
+        checked_td += st.edges_checked;
+
+        t0 = now_seconds();
+        bfs_csr(g, s, dist2, prev, 1, &st);
+        t_do += now_seconds() - t0;
+        checked_do += st.edges_checked;
+        same &= memcmp(dist, dist2, (size_t)n * sizeof(int)) == 0;
+
+        long long comp_arcs = 0;
+        for (int v = 0; v < n; ++v)
+            if (dist[v] != (int)INF) comp_arcs += graph_degree(g, v);
+        teps_edges += comp_arcs / 2;
+        printf("  source %d: reached %d, %d levels, %d top-down + %d bottom-up steps\n",
+            s, reached, st.levels, st.td_steps, st.bu_steps);
+        done++;
+    }
+    if (done) {
+        printf("Top-down:              %.3f ms/BFS, %.1f M TEPS, %.2f edge checks per edge\n",
+            t_td * 1e3 / done, teps_edges / t_td / 1e6, (double)checked_td / teps_edges);
+        printf("Direction-optimizing:  %.3f ms/BFS, %.1f M TEPS, %.2f edge checks per edge\n",
+            t_do * 1e3 / done, teps_edges / t_do / 1e6, (double)checked_do / teps_edges);
+        printf("Distances identical: %s\n", same ? "yes" : "NO");
+    }
+    free(dist);
+    free(prev);
+    free(dist2);
+    return same ? 0 : 1;
+}
+
+/* ---------- Multi-source bit-parallel BFS ---------- */
+
+int ctz64(uint64_t x) {
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return (int)i;
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+// All-pairs hop distances: hops[(size_t)s * n + v], HOPS_FAR when v is
+// unreachable from s (or 255+ hops away). Sources run 64 * MSBFS_WORDS at a
+// time: every vertex keeps a bitmask of the sources that have seen it and of
+// those whose frontier contains it, so one pass advances all of them by a
+// level. Wide frontiers pull (next[v] = OR of frontier[u] over u ~ v, minus
+// seen[v]) over all vertices; narrow ones (< n/8 vertices, e.g. on
+// long-diameter graphs) push from the active vertices only. Levels land in a
+// vertex-major batch buffer first (contiguous per vertex) and are transposed
+// into source rows once per pass.
+uint8_t* msbfs_all_pairs(const Graph* g) {
+    int n = g->n;
+    size_t mask_bytes = (size_t)n * MSBFS_WORDS * sizeof(uint64_t);
+    uint8_t* hops = (uint8_t*)malloc((size_t)n * n + 1);
+    uint64_t* seen = (uint64_t*)malloc(mask_bytes + 1);
+    uint64_t* frontier = (uint64_t*)malloc(mask_bytes + 1);
+    uint64_t* next = (uint64_t*)malloc(mask_bytes + 1);
+    int* active = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int* touched = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    uint8_t* is_touched = (uint8_t*)calloc((size_t)n + 1, 1);
+    uint8_t* lvl = (uint8_t*)malloc((size_t)n * 64 * MSBFS_WORDS + 1);
+    if (!hops || !seen || !frontier || !next || !active || !touched || !is_touched || !lvl) {
+        fprintf(stderr, "msbfs: out of memory for n=%d\n", n);
+        free(hops); free(seen); free(frontier); free(next); free(active); free(touched); free(is_touched); free(lvl);
+        return NULL;
+    }
+
+    for (int s0 = 0; s0 < n; s0 += 64 * MSBFS_WORDS) {
+        int batch = n - s0 < 64 * MSBFS_WORDS ? n - s0 : 64 * MSBFS_WORDS;
+        memset(seen, 0, mask_bytes);
+        memset(frontier, 0, mask_bytes);
+        memset(lvl, HOPS_FAR, (size_t)n * 64 * MSBFS_WORDS);
+        for (int i = 0; i < batch; ++i) {
+            int src = s0 + i;
+            seen[(size_t)src * MSBFS_WORDS + i / 64] |= 1ULL << (i % 64);
+            frontier[(size_t)src * MSBFS_WORDS + i / 64] |= 1ULL << (i % 64);
+            lvl[(size_t)src * 64 * MSBFS_WORDS + i] = 0;
+            active[i] = src;
+        }
+        // have_list: active[] lists the nonzero frontier entries;
+        // next_dirty: next may hold stale masks (a pull level overwrote it)
+        int nactive = batch, have_list = 1, next_dirty = 1;
+        for (int level = 1; nactive > 0 && level < HOPS_FAR; ++level) {
+            int nn = 0;
+            if (nactive < n / 8) {
+                if (!have_list) {
+                    nactive = 0;
+                    for (int v = 0; v < n; ++v) {
+                        uint64_t any = 0;
+                        for (int w = 0; w < MSBFS_WORDS; ++w) any |= frontier[(size_t)v * MSBFS_WORDS + w];
+                        if (any) active[nactive++] = v;
+                    }
+                }
+                if (next_dirty) memset(next, 0, mask_bytes);
+                int nt = 0;
+                for (int i = 0; i < nactive; ++i) {
+                    const uint64_t* fu = frontier + (size_t)active[i] * MSBFS_WORDS;
+                    for (int64_t e = g->offsets[active[i]]; e < g->offsets[active[i] + 1]; ++e) {
+                        int v = g->nbrs[e];
+                        if (!is_touched[v]) { is_touched[v] = 1; touched[nt++] = v; }
+                        for (int w = 0; w < MSBFS_WORDS; ++w) next[(size_t)v * MSBFS_WORDS + w] |= fu[w];
+                    }
+                }
+                for (int j = 0; j < nt; ++j) {
+                    int v = touched[j];
+                    uint64_t any = 0;
+                    is_touched[v] = 0;
+                    for (int w = 0; w < MSBFS_WORDS; ++w) {
+                        uint64_t* nv = next + (size_t)v * MSBFS_WORDS + w;
+                        uint64_t fresh = *nv & ~seen[(size_t)v * MSBFS_WORDS + w];
+                        *nv = fresh;
+                        seen[(size_t)v * MSBFS_WORDS + w] |= fresh;
+                        any |= fresh;
+                        for (; fresh; fresh &= fresh - 1)
+                            lvl[(size_t)v * 64 * MSBFS_WORDS + w * 64 + ctz64(fresh)] = (uint8_t)level;
+                    }
+                    if (any) touched[nn++] = v;
+                }
+                // the old frontier is nonzero only on active[]: clear it for reuse as next
+                for (int i = 0; i < nactive; ++i)
+                    memset(frontier + (size_t)active[i] * MSBFS_WORDS, 0, MSBFS_WORDS * sizeof(uint64_t));
+                int* t = active; active = touched; touched = t;
+                have_list = 1;
+                next_dirty = 0;
+            }
+            else {
+#pragma omp parallel for schedule(dynamic, 1024) reduction(+:nn)
+                for (int v = 0; v < n; ++v) {
+                    uint64_t acc[MSBFS_WORDS] = { 0 }, full = ~0ULL, any = 0;
+                    uint64_t* sv = seen + (size_t)v * MSBFS_WORDS;
+                    uint64_t* nv = next + (size_t)v * MSBFS_WORDS;
+                    for (int w = 0; w < MSBFS_WORDS; ++w) full &= sv[w];
+                    if (full != ~0ULL)  // else every source has seen v already
+                        for (int64_t e = g->offsets[v]; e < g->offsets[v + 1]; ++e) {
+                            const uint64_t* fu = frontier + (size_t)g->nbrs[e] * MSBFS_WORDS;
+                            for (int w = 0; w < MSBFS_WORDS; ++w) acc[w] |= fu[w];
+                        }
+                    for (int w = 0; w < MSBFS_WORDS; ++w) {
+                        uint64_t fresh = acc[w] & ~sv[w];
+                        nv[w] = fresh;
+                        sv[w] |= fresh;
+                        any |= fresh;
+                        for (; fresh; fresh &= fresh - 1)
+                            lvl[(size_t)v * 64 * MSBFS_WORDS + w * 64 + ctz64(fresh)] = (uint8_t)level;
+                    }
+                    nn += any != 0;
+                }
+                have_list = 0;
+                next_dirty = 1;
+            }
+            uint64_t* t = frontier; frontier = next; next = t;
+            nactive = nn;
+        }
+        // vertex-major lvl -> source rows, 64 vertices at a time
+#pragma omp parallel for schedule(static)
+        for (int v0 = 0; v0 < n; v0 += 64)
+            for (int i = 0; i < batch; ++i)
+                for (int v = v0; v < n && v < v0 + 64; ++v)
+                    hops[(size_t)(s0 + i) * n + v] = lvl[(size_t)v * 64 * MSBFS_WORDS + i];
+    }
+    free(seen);
+    free(frontier);
+    free(next);
+    free(active);
+    free(touched);
+    free(is_touched);
+    free(lvl);
+    return hops;
+}
+
+// hops as a flat file: "HWAPSP8\0", uint64 n, then n*n uint8 (row = source)
+int save_hops(const char* path, const uint8_t* hops, int n) {
+    FILE* fp = fopen(path, "wb");
+    uint64_t n64 = (uint64_t)n;
+    if (!fp) { perror(path); return 1; }
+    int ok = fwrite("HWAPSP8", 1, 8, fp) == 8 && fwrite(&n64, sizeof(n64), 1, fp) == 1
+        && fwrite(hops, 1, (size_t)n * n, fp) == (size_t)n * n;
+    ok &= fclose(fp) == 0;
+    if (!ok) fprintf(stderr, "%s: write failed\n", path);
+    return ok ? 0 : 1;
+}
+
+// MS-BFS all-pairs vs one BFS per source (timed on a sample, extrapolated)
+int run_apsp_benchmark(const Graph* g, const char* out_path) {
+    int n = g->n;
+    if ((double)n * n > 4e9) { fprintf(stderr, "apsp: n=%d needs n^2 bytes, too large\n", n); return 1; }
+    printf("All-pairs hops: n=%d, edges=%lld, %d sources per pass\n", n, g->m / 2, 64 * MSBFS_WORDS);
+
+    double t0 = now_seconds();
+    uint8_t* hops = msbfs_all_pairs(g);
+    double t_ms = now_seconds() - t0;
+    if (!hops) return 1;
+    printf("MS-BFS: %.3f s for %d sources (%d passes), %zu Bytes matrix\n", t_ms, n,
+        (n + 64 * MSBFS_WORDS - 1) / (64 * MSBFS_WORDS), (size_t)n * n);
+
+    int* dist = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int* prev = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int sample = n < 64 ? n : 64, same = 1;
+    uint64_t seed = (uint64_t)time(NULL);
+    t0 = now_seconds();
+    for (int k = 0; k < sample; ++k) {
+        int s = (int)(rng_next(&seed) % (uint64_t)n);
+        bfs_csr(g, s, dist, prev, 1, NULL);
+        for (int v = 0; v < n; ++v) {
+            int d = dist[v] == (int)INF || dist[v] >= HOPS_FAR ? HOPS_FAR : dist[v];
+            same &= hops[(size_t)s * n + v] == d;
+        }
+    }
+    double t_single = (now_seconds() - t0) / sample;
+    printf("Single-source BFS: %.3f ms each -> %.3f s for all %d sources (%.1fx MS-BFS time)\n",
+        t_single * 1e3, t_single * n, n, t_single * n / t_ms);
+    printf("Rows match single-source BFS (%d sampled): %s\n", sample, same ? "yes" : "NO");
+
+    int rc = same ? 0 : 1;
+    if (out_path && save_hops(out_path, hops, n) == 0) printf("Distance matrix written to %s\n", out_path);
+    free(dist);
+    free(prev);
+    free(hops);
+    return rc;
+}
+
+/* ---------- Parallel level-synchronous BFS ---------- */
+
+int max_threads(void) {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+// returns the value seen at *p; the swap happened iff that equals expected
+int atomic_cas_int(volatile int* p, int expected, int desired) {
+#ifdef _MSC_VER
+    return (int)_InterlockedCompareExchange((volatile long*)p, desired, expected);
+#else
+    return __sync_val_compare_and_swap(p, expected, desired);
+#endif
+}
+
+// Parallel top-down BFS with the same dist/prev (and queue order) as
+// bfs_csr(..., 0, ...) and therefore as bfs(). Each level:
+//  1. the frontier is cut into edge-balanced contiguous chunks; a thread
+//     claims an unvisited neighbor v of frontier[i] by CAS on dist[v], writing
+//     the claim code i - n (below every real distance, lower i wins), and
+//     notes (v, i) in its chunk's slice of a scratch buffer;
+//  2. each chunk keeps the notes whose claim survived (the lowest frontier
+//     index, i.e. the vertex the serial queue would reach first), sets their
+//     dist/prev and compacts them in place, still in discovery order, noting
+//     each kept vertex's degree;
+//  3. the slices are concatenated in chunk order into the next frontier,
+//     writing its degree prefix from per-chunk degree sums on the way.
+// Only O(chunks) work per level is serial: prefix sums over chunk totals and
+// a binary search per chunk bound.
+// Returns the number of reached vertices.
+int bfs_parallel(const Graph* g, int s, int* dist, int* prev) {
+    int n = g->n, T = max_threads(), C = T * PBFS_CHUNKS_PER_THREAD;
+    int* frontier = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int* next = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int64_t* edge_pos = (int64_t*)malloc(((size_t)n + 1) * sizeof(int64_t));  // frontier degree prefix
+    int64_t* next_pos = (int64_t*)malloc(((size_t)n + 1) * sizeof(int64_t));  // the same for next
+    int* bound = (int*)malloc(((size_t)C + 1) * sizeof(int));                 // chunk c = frontier[bound[c] .. bound[c+1])
+    int64_t* found = (int64_t*)malloc(((size_t)C + 1) * sizeof(int64_t));
+    int64_t* deg_sum = (int64_t*)malloc(((size_t)C + 1) * sizeof(int64_t));  // edges of each chunk's kept vertices
+    int* note_v = NULL;
+    int* note_i = NULL;
+    int64_t note_cap = 0;
+
+#pragma omp parallel for
+    for (int i = 0; i < n; ++i) {
+        dist[i] = (int)INF;
+        prev[i] = -1;
+    }
+    dist[s] = 0;
+    frontier[0] = s;
+    edge_pos[0] = 0;
+    edge_pos[1] = graph_degree(g, s);
+    int nf = 1, reached = 1;
+
+    for (int level = 0; nf > 0; ++level) {
+        int64_t m_f = edge_pos[nf];
+        if (m_f > note_cap) {
+            free(note_v);
+            free(note_i);
+            note_cap = m_f;
+            note_v = (int*)malloc((size_t)note_cap * sizeof(int));
+            note_i = (int*)malloc((size_t)note_cap * sizeof(int));
+        }
+        // chunk c starts at the first frontier vertex whose edges begin at or after c * m_f / C
+        bound[0] = 0;
+        bound[C] = nf;
+        for (int c = 1; c < C; ++c) {
+            int64_t target = m_f * c / C;
+            int lo = bound[c - 1], hi = nf;
+            while (lo < hi) {
+                int mid = lo + (hi - lo) / 2;
+                if (edge_pos[mid] < target) lo = mid + 1; else hi = mid;
+            }
+            bound[c] = lo;
+        }
+
+#pragma omp parallel for schedule(dynamic, 1)
+        for (int c = 0; c < C; ++c) {
+            int64_t k = edge_pos[bound[c]];
+            for (int i = bound[c]; i < bound[c + 1]; ++i) {
+                int u = frontier[i], code = i - n;
+                for (int64_t e = g->offsets[u]; e < g->offsets[u + 1]; ++e) {
+                    int v = g->nbrs[e];
+                    int cur = dist[v];
+                    if (T == 1) {   // one thread walks i in order: the first claim is final
+                        if (cur == (int)INF) { dist[v] = level + 1; prev[v] = u; note_v[k++] = v; }
+                        continue;
+                    }
+                    // unvisited (INF) or claimed this level by a later frontier index
+                    while (cur == (int)INF || (cur < 0 && code < cur)) {
+                        int seen = atomic_cas_int(&dist[v], cur, code);
+                        if (seen == cur) { note_v[k] = v; note_i[k++] = i; break; }
+                        cur = seen;
+                    }
+                }
+            }
+            found[c + 1] = k - edge_pos[bound[c]];
+        }
+
+#pragma omp parallel for schedule(dynamic, 1)
+        for (int c = 0; c < C; ++c) {
+            int64_t base = edge_pos[bound[c]], k = 0, d = 0;
+            for (int64_t j = 0; j < found[c + 1]; ++j) {
+                int v = note_v[base + j];
+                if (T > 1) {
+                    int i = note_i[base + j];
+                    if (dist[v] != i - n) continue;   // a lower frontier index took v
+                    dist[v] = level + 1;
+                    prev[v] = frontier[i];
+                }
+                note_v[base + k] = v;
+                note_i[base + k++] = graph_degree(g, v);
+                d += graph_degree(g, v);
+            }
+            found[c + 1] = k;
+            deg_sum[c + 1] = d;
+        }
+
+        found[0] = deg_sum[0] = 0;
+        for (int c = 0; c < C; ++c) {
+            found[c + 1] += found[c];
+            deg_sum[c + 1] += deg_sum[c];
+        }
+#pragma omp parallel for schedule(dynamic, 1)
+        for (int c = 0; c < C; ++c) {
+            int64_t base = edge_pos[bound[c]], pos = deg_sum[c];
+            for (int64_t j = 0; j < found[c + 1] - found[c]; ++j) {
+                next[found[c] + j] = note_v[base + j];
+                next_pos[found[c] + j] = pos;
+                pos += note_i[base + j];
+            }
+        }
+        next_pos[found[C]] = deg_sum[C];
+
+        int* t = frontier; frontier = next; next = t;
+        int64_t* tp = edge_pos; edge_pos = next_pos; next_pos = tp;
+        nf = (int)found[C];
+        reached += nf;
+    }
+    free(frontier);
+    free(next);
+    free(edge_pos);
+    free(next_pos);
+    free(bound);
+    free(found);
+    free(deg_sum);
+    free(note_v);
+    free(note_i);
+    return reached;
+}
+
+// Serial top-down BFS vs bfs_parallel at 1, 2, 4, ... threads
+int run_pbfs_benchmark(const Graph* g, int sources) {
+    int n = g->n, T = max_threads(), same = 1, done = 0;
+    int* dist = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int* prev = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int* dist2 = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int* prev2 = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int* src = (int*)malloc((size_t)sources * sizeof(int) + sizeof(int));
+    uint64_t seed = (uint64_t)time(NULL);
+    for (int k = 0; k < sources * 100 && done < sources; ++k) {
+        int s = (int)(rng_next(&seed) % (uint64_t)n);
+        if (graph_degree(g, s) > 0) src[done++] = s;
+    }
+    sources = done;
+    printf("Parallel BFS: n=%d, edges=%lld, %d sources, up to %d threads\n", n, g->m / 2, sources, T);
+
+    long long teps_edges = 0;
+    double t_serial = 0;
+    for (int k = 0; k < sources; ++k) {
+        double t0 = now_seconds();
+        bfs_csr(g, src[k], dist, prev, 0, NULL);
+        t_serial += now_seconds() - t0;
+        for (int v = 0; v < n; ++v)
+            if (dist[v] != (int)INF) teps_edges += graph_degree(g, v);
+    }
+    teps_edges /= 2;
+    if (sources) printf("Serial top-down:      %9.3f ms/BFS  %8.1f M TEPS\n",
+        t_serial * 1e3 / sources, teps_edges / t_serial / 1e6);
+
+    for (int threads = 1; sources; threads *= 2) {
+        if (threads > T) threads = T;
+#ifdef _OPENMP
+        omp_set_num_threads(threads);
+#endif
+        double t_par = 0;
+        for (int k = 0; k < sources; ++k) {
+            bfs_csr(g, src[k], dist, prev, 0, NULL);
+            double t0 = now_seconds();
+            bfs_parallel(g, src[k], dist2, prev2);
+            t_par += now_seconds() - t0;
+            same &= memcmp(dist, dist2, (size_t)n * sizeof(int)) == 0
+                && memcmp(prev, prev2, (size_t)n * sizeof(int)) == 0;
+        }
+        printf("Parallel, %2d threads: %9.3f ms/BFS  %8.1f M TEPS  (%.2fx serial)\n", threads,
+            t_par * 1e3 / sources, teps_edges / t_par / 1e6, t_serial / t_par);
+        if (threads == T) break;
+    }
+#ifdef _OPENMP
+    omp_set_num_threads(T);
+#endif
+    printf("dist/prev identical to serial BFS: %s\n", same ? "yes" : "NO");
+    free(dist);
+    free(prev);
+    free(dist2);
+    free(prev2);
+    free(src);
+    return same ? 0 : 1;
+}
+
+/* ---------- Connected components ---------- */
+
+// Concurrent union-find on parent[]: a root is linked under the smaller root
+// with a CAS, so parent[x] <= x always holds and the root of a component is
+// its smallest vertex. find() does path halving with plain stores; any value
+// written is an ancestor, so racing halvings only shorten paths.
+int uf_find(volatile int* parent, int x) {
+    for (;;) {
+        int p = parent[x], gp = parent[p];
+        if (p == gp) return p;
+        parent[x] = gp;
+        x = gp;
+    }
+}
+
+void uf_union(volatile int* parent, int u, int v) {
+    for (;;) {
+        u = uf_find(parent, u);
+        v = uf_find(parent, v);
+        if (u == v) return;
+        if (u < v) { int t = u; u = v; v = t; }
+        if (atomic_cas_int(&parent[u], u, v) == u) return;   // u was still a root
+    }
+}
+
+// comp[v] = root of v; after this every parent points straight at its root
+void uf_flatten(int* parent, int n) {
+#pragma omp parallel for schedule(static, 4096)
+    for (int v = 0; v < n; ++v) parent[v] = uf_find(parent, v);
+}
+
+// Components by a parallel union over every edge (u < v copy only).
+// comp[v] = smallest vertex of v's component; returns the component count.
+int components_unionfind(const Graph* g, int* comp) {
+    int n = g->n, count = 0;
+#pragma omp parallel for
+    for (int v = 0; v < n; ++v) comp[v] = v;
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int u = 0; u < n; ++u)
+        for (int64_t e = g->offsets[u]; e < g->offsets[u + 1]; ++e)
+            if (g->nbrs[e] > u) uf_union(comp, u, g->nbrs[e]);
+    uf_flatten(comp, n);
+#pragma omp parallel for reduction(+:count)
+    for (int v = 0; v < n; ++v) count += comp[v] == v;
+    return count;
+}
+
+// Afforest (Sutton et al. 2018): union only the first CC_NEIGHBOR_ROUNDS
+// neighbors of every vertex, which already joins most of a giant component;
+// guess that component from CC_SAMPLES random vertices, then finish with the
+// remaining edges of vertices outside it. Same output as components_unionfind.
+int components_afforest(const Graph* g, int* comp) {
+    int n = g->n, count = 0;
+#pragma omp parallel for
+    for (int v = 0; v < n; ++v) comp[v] = v;
+    for (int r = 0; r < CC_NEIGHBOR_ROUNDS; ++r) {
+#pragma omp parallel for schedule(dynamic, 4096)
+        for (int u = 0; u < n; ++u)
+            if (graph_degree(g, u) > r) uf_union(comp, u, g->nbrs[g->offsets[u] + r]);
+        uf_flatten(comp, n);
+    }
+
+    // most frequent root among the samples (sorted, longest run)
+    int giant = -1;
+    if (n > 0) {
+        int samples[CC_SAMPLES], best = 0;
+        uint64_t seed = 0x41464652ULL;
+        for (int i = 0; i < CC_SAMPLES; ++i) samples[i] = comp[rng_next(&seed) % (uint64_t)n];
+        qsort(samples, CC_SAMPLES, sizeof(int), cmp_int);
+        for (int i = 0, run = 1; i < CC_SAMPLES; ++i, ++run) {
+            if (i > 0 && samples[i] != samples[i - 1]) run = 1;
+            if (run > best) { best = run; giant = samples[i]; }
+        }
+    }
+    // an edge between the giant component and vertex v is also stored at v,
+    // so skipping every giant vertex loses no link
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int u = 0; u < n; ++u) {
+        if (uf_find(comp, u) == giant) continue;
+        for (int64_t e = g->offsets[u] + CC_NEIGHBOR_ROUNDS; e < g->offsets[u + 1]; ++e)
+            uf_union(comp, u, g->nbrs[e]);
+    }
+    uf_flatten(comp, n);
+#pragma omp parallel for reduction(+:count)
+    for (int v = 0; v < n; ++v) count += comp[v] == v;
+    return count;
+}
+
+// Serial reference: BFS from each unlabeled vertex in id order
+int components_bfs(const Graph* g, int* comp) {
+    int n = g->n, count = 0;
+    int* queue = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    for (int v = 0; v < n; ++v) comp[v] = -1;
+    for (int s = 0; s < n; ++s) {
+        if (comp[s] >= 0) continue;
+        int head = 0, tail = 0;
+        comp[s] = s;
+        queue[tail++] = s;
+        while (head < tail) {
+            int u = queue[head++];
+            for (int64_t e = g->offsets[u]; e < g->offsets[u + 1]; ++e)
+                if (comp[g->nbrs[e]] < 0) { comp[g->nbrs[e]] = s; queue[tail++] = g->nbrs[e]; }
+        }
+        count++;
+    }
+    free(queue);
+    return count;
+}
+
+/* ---------- Bidirectional BFS for s-t queries ---------- */
+
+// Per-query scratch, allocated once and reused. A vertex is visited from the
+// s side iff seen_s[v] == stamp (likewise for t), so a query costs only the
+// vertices it touches instead of an O(n) reset.
+typedef struct {
+    int n, stamp;
+    int *seen_s, *seen_t;       // visit stamps
+    int *dist_s, *dist_t;       // hops from s / to t, valid when seen
+    int *prev_s, *next_t;       // parent towards s / successor towards t
+    int *queue_s, *queue_t;     // each side's visit order; frontier = last level
+    long long touched;          // edges scanned by the last query
+} BiBfs;
+
+BiBfs* bibfs_create(int n) {
+    BiBfs* w = (BiBfs*)malloc(sizeof(BiBfs));
+    w->n = n;
+    w->stamp = 0;
+    w->seen_s = (int*)calloc((size_t)n + 1, sizeof(int));
+    w->seen_t = (int*)calloc((size_t)n + 1, sizeof(int));
+    w->dist_s = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    w->dist_t = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    w->prev_s = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    w->next_t = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    w->queue_s = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    w->queue_t = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    w->touched = 0;
+    return w;
+}
+
+void bibfs_free(BiBfs* w) {
+    if (!w) return;
+    free(w->seen_s);
+    free(w->seen_t);
+    free(w->dist_s);
+    free(w->dist_t);
+    free(w->prev_s);
+    free(w->next_t);
+    free(w->queue_s);
+    free(w->queue_t);
+    free(w);
+}
+
+// Shortest s -> t hop count, or -1 if t is unreachable. Each round expands one
+// whole level of whichever side has the smaller frontier (fewer edges to scan),
+// and stops after the first level in which the two searches touch: the best
+// meeting vertex of that level gives a shortest path. If path is non-NULL it
+// receives s .. t (hops + 1 vertices), rebuilt like print_path: walk prev_s
+// back to s, reverse, then follow next_t on to t.
+int bibfs_query(const Graph* g, BiBfs* w, int s, int t, int* path) {
+    w->touched = 0;
+    if (s == t) {
+        if (path) path[0] = s;
+        return 0;
+    }
+    if (++w->stamp == INT32_MAX) {   // stamps wrapped: start over
+        memset(w->seen_s, 0, (size_t)w->n * sizeof(int));
+        memset(w->seen_t, 0, (size_t)w->n * sizeof(int));
+        w->stamp = 1;
+    }
+    int stamp = w->stamp;
+    w->seen_s[s] = stamp; w->dist_s[s] = 0; w->prev_s[s] = -1; w->queue_s[0] = s;
+    w->seen_t[t] = stamp; w->dist_t[t] = 0; w->next_t[t] = -1; w->queue_t[0] = t;
+    // frontier of each side = queue[head .. tail); vol = its total degree
+    int head_s = 0, tail_s = 1, head_t = 0, tail_t = 1;
+    long long vol_s = graph_degree(g, s), vol_t = graph_degree(g, t);
+    int best = -1, meet = -1;
+
+    while (best < 0 && head_s < tail_s && head_t < tail_t) {
+        int fwd = vol_s <= vol_t;
+        int *seen = fwd ? w->seen_s : w->seen_t, *other = fwd ? w->seen_t : w->seen_s;
+        int *dist = fwd ? w->dist_s : w->dist_t, *odist = fwd ? w->dist_t : w->dist_s;
+        int *link = fwd ? w->prev_s : w->next_t, *queue = fwd ? w->queue_s : w->queue_t;
+        int head = fwd ? head_s : head_t, tail = fwd ? tail_s : tail_t, end = tail;
+        long long vol = 0;
+        for (int i = head; i < end; ++i) {
+            int u = queue[i];
+            for (int64_t e = g->offsets[u]; e < g->offsets[u + 1]; ++e) {
+                int v = g->nbrs[e];
+                if (seen[v] == stamp) continue;
+                seen[v] = stamp;
+                dist[v] = dist[u] + 1;
+                link[v] = u;
+                queue[tail++] = v;
+                vol += graph_degree(g, v);
+                if (other[v] == stamp && (best < 0 || dist[v] + odist[v] < best)) {
+                    best = dist[v] + odist[v];
+                    meet = v;
+                }
+            }
+            w->touched += graph_degree(g, u);
+        }
+        if (fwd) { head_s = end; tail_s = tail; vol_s = vol; }
+        else { head_t = end; tail_t = tail; vol_t = vol; }
+    }
+    if (best < 0 || !path) return best;
+
+    int len = 0;
+    for (int v = meet; v != -1; v = w->prev_s[v]) path[len++] = v;
+    for (int i = 0, j = len - 1; i < j; ++i, --j) { int x = path[i]; path[i] = path[j]; path[j] = x; }
+    for (int v = w->next_t[meet]; v != -1; v = w->next_t[v]) path[len++] = v;
+    return best;
+}
+
+// "Path: a -> b -> c" for a bibfs_query path, same format as print_path
+void print_hop_path(FILE* out, const int* path, int hops) {
+    if (hops < 0) {
+        fprintf(out, "  Path: (does not exist)\n");
+        return;
+    }
+    fprintf(out, "  Path: ");
+    for (int i = 0; i <= hops; ++i) fprintf(out, i ? " -> %d" : "%d", path[i]);
+    fprintf(out, "\n");
+}
+
+int cmp_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Answer s-t queries with bidirectional BFS and report per-query latency.
+// queries is a text file of "s t" lines (# comments allowed) or, if it is a
+// number, that many random pairs. Answers go to out ("s t hops" plus the path)
+// when given. A sample of queries is re-checked against a full bfs_csr.
+int run_query_benchmark(const Graph* g, const char* queries, const char* out_path) {
+    int n = g->n;
+    long long q = 0, cap = 1024;
+    int* qs = (int*)malloc((size_t)cap * sizeof(int));
+    int* qt = (int*)malloc((size_t)cap * sizeof(int));
+    if (queries[0] >= '0' && queries[0] <= '9') {
+        uint64_t seed = (uint64_t)time(NULL) ^ 0x51554552ULL;   // not graph_random's stream
+        cap = atoll(queries);
+        qs = (int*)realloc(qs, (size_t)cap * sizeof(int) + sizeof(int));
+        qt = (int*)realloc(qt, (size_t)cap * sizeof(int) + sizeof(int));
+        for (q = 0; q < cap; ++q) {
+            qs[q] = (int)(rng_next(&seed) % (uint64_t)n);
+            qt[q] = (int)(rng_next(&seed) % (uint64_t)n);
+        }
+    }
+    else {
+        FILE* fp = fopen(queries, "r");
+        if (!fp) { perror(queries); free(qs); free(qt); return 1; }
+        char line[256];
+        long long lineno = 0;
+        while (fgets(line, sizeof(line), fp)) {
+            long long s, t;
+            lineno++;
+            if (line[0] == '#' || line[0] == '%') continue;
+            if (sscanf(line, "%lld %lld", &s, &t) != 2) continue;
+            if (s < 0 || s >= n || t < 0 || t >= n) {
+                fprintf(stderr, "%s:%lld: vertex out of range [0, %d)\n", queries, lineno, n);
+                continue;
+            }
+            if (q == cap) {
+                cap *= 2;
+                qs = (int*)realloc(qs, (size_t)cap * sizeof(int));
+                qt = (int*)realloc(qt, (size_t)cap * sizeof(int));
+            }
+            qs[q] = (int)s;
+            qt[q++] = (int)t;
+        }
+        fclose(fp);
+    }
+    FILE* out = NULL;
+    if (out_path && !(out = fopen(out_path, "w"))) { perror(out_path); free(qs); free(qt); return 1; }
+
+    BiBfs* w = bibfs_create(n);
+    int* path = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int* comp = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    double* lat = (double*)malloc((size_t)q * sizeof(double) + sizeof(double));
+    long long found = 0, hop_sum = 0, touched = 0, cut = 0;
+    double total = 0;
+    printf("Bidirectional BFS: n=%d, edges=%lld, %lld queries\n", n, g->m / 2, q);
+    double t_cc = now_seconds();
+    int ncomp = components_afforest(g, comp);
+    printf("Components: %d in %.3f ms; pairs in different ones are answered without a search\n",
+        ncomp, (now_seconds() - t_cc) * 1e3);
+    for (long long i = 0; i < q; ++i) {
+        double t0 = now_seconds();
+        int split = comp[qs[i]] != comp[qt[i]];
+        int hops = split ? -1 : bibfs_query(g, w, qs[i], qt[i], out ? path : NULL);
+        lat[i] = now_seconds() - t0;
+        total += lat[i];
+        cut += split;
+        if (!split) touched += w->touched;
+        if (hops >= 0) { found++; hop_sum += hops; }
+        if (out) {
+            fprintf(out, "%d %d %d\n", qs[i], qt[i], hops);
+            print_hop_path(out, path, hops);
+        }
+    }
+    if (out) fclose(out);
+
+    if (q) {
+        qsort(lat, (size_t)q, sizeof(double), cmp_double);
+        printf("Reachable: %lld of %lld (%lld cut by component), mean %.2f hops, %.1f edges scanned per query (%.3f%% of graph)\n",
+            found, q, cut, found ? (double)hop_sum / found : 0.0, (double)touched / q,
+            g->m ? 100.0 * touched / q / g->m : 0.0);
+        printf("Latency (us): mean %.2f  p50 %.2f  p90 %.2f  p99 %.2f  max %.2f  -> %.0f queries/s\n",
+            total * 1e6 / q, lat[q / 2] * 1e6, lat[q * 9 / 10] * 1e6, lat[q * 99 / 100] * 1e6,
+            lat[q - 1] * 1e6, q / total);
+    }
+
+    // correctness and baseline: full single-source BFS on up to 64 of the queries
+    int* dist = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int* prev = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int ok = 1, checked = q < 64 ? (int)q : 64;
+    double t_full = 0, t_bi = 0;
+    for (int k = 0; k < checked; ++k) {
+        long long i = q * k / checked;
+        double t0 = now_seconds();
+        bfs_csr(g, qs[i], dist, prev, 0, NULL);
+        t_full += now_seconds() - t0;
+        t0 = now_seconds();
+        int hops = bibfs_query(g, w, qs[i], qt[i], path);
+        t_bi += now_seconds() - t0;
+        int want = dist[qt[i]] == (int)INF ? -1 : dist[qt[i]];
+        ok &= hops == want;
+        if (hops > 0) {   // path must start at s, end at t and use real edges
+            ok &= path[0] == qs[i] && path[hops] == qt[i];
+            for (int h = 0; h < hops && ok; ++h) {
+                int u = path[h], v = path[h + 1], hit = 0;
+                for (int64_t e = g->offsets[u]; e < g->offsets[u + 1] && !hit; ++e) hit = g->nbrs[e] == v;
+                ok &= hit;
+            }
+        }
+    }
+    if (checked) {
+        printf("Full BFS per query: %.2f us vs bidirectional %.2f us (%.1fx)\n",
+            t_full * 1e6 / checked, t_bi * 1e6 / checked, t_bi > 0 ? t_full / t_bi : 0.0);
+        printf("Hop counts and paths match full BFS on %d queries: %s\n", checked, ok ? "yes" : "NO");
+    }
+    free(dist);
+    free(prev);
+    free(lat);
+    free(path);
+    free(comp);
+    bibfs_free(w);
+    free(qs);
+    free(qt);
+    return ok ? 0 : 1;
+}
+
+// BFS labeling vs union-find vs Afforest, then random s-t queries with and
+// without the O(1) component check in front of bidirectional BFS
+int run_cc_benchmark(const Graph* g, int queries) {
+    int n = g->n, same = 1;
+    int* ref = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int* comp = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    printf("Connected components: n=%d, edges=%lld, %d threads\n", n, g->m / 2, max_threads());
+
+    double t0 = now_seconds();
+    int count = components_bfs(g, ref);
+    printf("  %-22s %9.3f ms  %d components\n", "BFS labeling (serial)", (now_seconds() - t0) * 1e3, count);
+    for (int alg = 0; alg < 2; ++alg) {
+        t0 = now_seconds();
+        int c = alg ? components_afforest(g, comp) : components_unionfind(g, comp);
+        printf("  %-22s %9.3f ms  %d components\n", alg ? "Afforest" : "Union-find", (now_seconds() - t0) * 1e3, c);
+        same &= c == count && memcmp(ref, comp, (size_t)n * sizeof(int)) == 0;
+    }
+    int* size = (int*)calloc((size_t)n + 1, sizeof(int));
+    int largest = 0, singletons = 0;
+    for (int v = 0; v < n; ++v) size[comp[v]]++;
+    for (int v = 0; v < n; ++v) {
+        if (size[v] > largest) largest = size[v];
+        singletons += size[v] == 1;
+    }
+    printf("Largest component %d vertices (%.1f%%), %d isolated vertices\n", largest, n ? 100.0 * largest / n : 0.0, singletons);
+
+    // separate passes over the same pairs; the untimed first one records the
+    // answers and warms the search scratch for both timed passes
+    BiBfs* w = bibfs_create(n);
+    uint64_t seed = (uint64_t)time(NULL) ^ 0x43435151ULL;
+    int* qs = (int*)malloc((size_t)queries * sizeof(int) + sizeof(int));
+    int* qt = (int*)malloc((size_t)queries * sizeof(int) + sizeof(int));
+    int* ans = (int*)malloc((size_t)queries * sizeof(int) + sizeof(int));
+    int cut = 0;
+    for (int i = 0; i < queries; ++i) {
+        qs[i] = (int)(rng_next(&seed) % (uint64_t)n);
+        qt[i] = (int)(rng_next(&seed) % (uint64_t)n);
+    }
+    for (int i = 0; i < queries; ++i) ans[i] = bibfs_query(g, w, qs[i], qt[i], NULL);
+    t0 = now_seconds();
+    for (int i = 0; i < queries; ++i) same &= bibfs_query(g, w, qs[i], qt[i], NULL) == ans[i];
+    double t_plain = now_seconds() - t0;
+    t0 = now_seconds();
+    for (int i = 0; i < queries; ++i) {
+        int hops = comp[qs[i]] != comp[qt[i]] ? -1 : bibfs_query(g, w, qs[i], qt[i], NULL);
+        cut += comp[qs[i]] != comp[qt[i]];
+        same &= hops == ans[i];
+    }
+    double t_check = now_seconds() - t0;
+    if (queries)
+        printf("s-t queries: %.2f us plain vs %.2f us with component check (%d of %d answered by the check)\n",
+            t_plain * 1e6 / queries, t_check * 1e6 / queries, cut, queries);
+    printf("Labels identical to BFS labeling, query answers unchanged: %s\n", same ? "yes" : "NO");
+    bibfs_free(w);
+    free(qs);
+    free(qt);
+    free(ans);
+    free(size);
+    free(ref);
+    free(comp);
+    return same ? 0 : 1;
+}
+
+/* ---------- Landmark distance oracle ---------- */
+
+// Offline index for s-t hop distances. Landmark mode keeps one BFS distance
+// per (vertex, landmark) and answers with triangle-inequality bounds; PLL mode
+// (pruned landmark labeling) keeps a small exact label per vertex.
+typedef struct {
+    int n, k;               // k = landmarks (landmark mode) or 0 (PLL)
+    int pll;
+    int* landmarks;         // k landmark vertices
+    uint16_t* dist;         // n * k, vertex-major: dist[v*k + i] = hops v <-> landmarks[i]
+    int64_t* label_off;     // PLL: label of v = [label_off[v], label_off[v+1])
+    int* label_hub;         // hub rank (position in the degree order), ascending per label
+    uint16_t* label_dist;   // hops v <-> hub
+} DistOracle;
+
+int cmp_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Vertices by descending degree (landmark and PLL hub order). Ties are broken
+// by a scrambled id, v * odd constant mod 2^32 (undone with its inverse), so
+// equal-degree vertices, e.g. on a grid, are not all picked from one corner.
+int* vertices_by_degree(const Graph* g) {
+    int n = g->n;
+    uint64_t* key = (uint64_t*)malloc((size_t)n * sizeof(uint64_t) + sizeof(uint64_t));
+    int* order = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    for (int v = 0; v < n; ++v)
+        key[v] = (uint64_t)(INT32_MAX - graph_degree(g, v)) << 32 | (uint32_t)((uint32_t)v * 2654435761u);
+    qsort(key, (size_t)n, sizeof(uint64_t), cmp_u64);
+    for (int i = 0; i < n; ++i) order[i] = (int)((uint32_t)key[i] * 244002641u);
+    free(key);
+    return order;
+}
+
+void oracle_free(DistOracle* o) {
+    if (!o) return;
+    free(o->landmarks);
+    free(o->dist);
+    free(o->label_off);
+    free(o->label_hub);
+    free(o->label_dist);
+    free(o);
+}
+
+DistOracle* oracle_alloc(int n) {
+    DistOracle* o = (DistOracle*)calloc(1, sizeof(DistOracle));
+    o->n = n;
+    return o;
+}
+
+// k landmarks, the k highest-degree vertices or k distinct random ones;
+// one BFS per landmark. NULL if some distance does not fit in uint16.
+DistOracle* oracle_build_landmarks(const Graph* g, int k, int random) {
+    int n = g->n, bad = 0;
+    if (k > n) k = n;
+    DistOracle* o = oracle_alloc(n);
+    o->k = k;
+    o->landmarks = (int*)malloc((size_t)k * sizeof(int) + sizeof(int));
+    o->dist = (uint16_t*)malloc((size_t)n * k * sizeof(uint16_t) + sizeof(uint16_t));
+    int* order = vertices_by_degree(g);
+    if (random) {   // partial Fisher-Yates over the vertex ids
+        uint64_t seed = (uint64_t)time(NULL) ^ 0x4C414E44ULL;
+        for (int i = 0; i < n; ++i) order[i] = i;
+        for (int i = 0; i < k; ++i) {
+            int j = i + (int)(rng_next(&seed) % (uint64_t)(n - i));
+            int x = order[i]; order[i] = order[j]; order[j] = x;
+        }
+    }
+    memcpy(o->landmarks, order, (size_t)k * sizeof(int));
+    free(order);
+
+#pragma omp parallel reduction(|:bad)
+    {
+        int* dist = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+        int* prev = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+#pragma omp for schedule(dynamic, 1)
+        for (int i = 0; i < k; ++i) {
+            bfs_csr(g, o->landmarks[i], dist, prev, 1, NULL);
+            for (int v = 0; v < n; ++v) {
+                if (dist[v] != (int)INF && dist[v] >= LM_FAR) bad = 1;
+                o->dist[(size_t)v * k + i] = dist[v] == (int)INF ? LM_FAR : (uint16_t)dist[v];
+            }
+        }
+        free(dist);
+        free(prev);
+    }
+    if (bad) {
+        fprintf(stderr, "oracle: distances of %d+ hops do not fit the index\n", LM_FAR);
+        oracle_free(o);
+        return NULL;
+    }
+    return o;
+}
+
+// Pruned landmark labeling (Akiba, Iwata, Yoshida 2013): BFS from every vertex
+// in degree order, but stop at any u whose distance the labels built so far
+// already give. Labels stay sorted by hub rank because hubs are added in
+// rank order. NULL if the labels outgrow PLL_MAX_ENTRIES.
+DistOracle* oracle_build_pll(const Graph* g) {
+    int n = g->n;
+    int* order = vertices_by_degree(g);
+    int* len = (int*)calloc((size_t)n + 1, sizeof(int));
+    int* cap = (int*)calloc((size_t)n + 1, sizeof(int));
+    int** hub = (int**)calloc((size_t)n + 1, sizeof(int*));
+    uint16_t** hd = (uint16_t**)calloc((size_t)n + 1, sizeof(uint16_t*));
+    uint16_t* root_d = (uint16_t*)malloc((size_t)n * sizeof(uint16_t) + sizeof(uint16_t));   // by hub rank
+    int* dist = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int* queue = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    long long entries = 0;
+    int ok = 1;
+    for (int v = 0; v < n; ++v) { root_d[v] = LM_FAR; dist[v] = -1; }
+
+    for (int r = 0; r < n && ok; ++r) {
+        int root = order[r], head = 0, tail = 0;
+        for (int j = 0; j < len[root]; ++j) root_d[hub[root][j]] = hd[root][j];
+        dist[root] = 0;
+        queue[tail++] = root;
+        while (head < tail) {
+            int u = queue[head++], d = dist[u], pruned = 0;
+            for (int j = 0; j < len[u] && !pruned; ++j)
+                pruned = root_d[hub[u][j]] != LM_FAR && root_d[hub[u][j]] + hd[u][j] <= d;
+            if (pruned) continue;
+            if (d >= LM_FAR || entries >= PLL_MAX_ENTRIES) { ok = 0; break; }
+            if (len[u] == cap[u]) {
+                cap[u] = cap[u] ? cap[u] * 2 : 4;
+                hub[u] = (int*)realloc(hub[u], (size_t)cap[u] * sizeof(int));
+                hd[u] = (uint16_t*)realloc(hd[u], (size_t)cap[u] * sizeof(uint16_t));
+            }
+            hub[u][len[u]] = r;
+            hd[u][len[u]++] = (uint16_t)d;
+            entries++;
+            for (int64_t e = g->offsets[u]; e < g->offsets[u + 1]; ++e) {
+                int w = g->nbrs[e];
+                if (dist[w] < 0) { dist[w] = d + 1; queue[tail++] = w; }
+            }
+        }
+        for (int i = 0; i < tail; ++i) dist[queue[i]] = -1;
+        for (int j = 0; j < len[root]; ++j) root_d[hub[root][j]] = LM_FAR;
+    }
+
+    DistOracle* o = NULL;
+    if (!ok) fprintf(stderr, "oracle: PLL labels exceed %lld entries or %d hops\n", (long long)PLL_MAX_ENTRIES, LM_FAR);
+    else {   // pack the per-vertex labels into one CSR
+        o = oracle_alloc(n);
+        o->pll = 1;
+        o->label_off = (int64_t*)malloc(((size_t)n + 1) * sizeof(int64_t));
+        o->label_hub = (int*)malloc((size_t)entries * sizeof(int) + sizeof(int));
+        o->label_dist = (uint16_t*)malloc((size_t)entries * sizeof(uint16_t) + sizeof(uint16_t));
+        o->label_off[0] = 0;
+        for (int v = 0; v < n; ++v) {
+            o->label_off[v + 1] = o->label_off[v] + len[v];
+            memcpy(o->label_hub + o->label_off[v], hub[v], (size_t)len[v] * sizeof(int));
+            memcpy(o->label_dist + o->label_off[v], hd[v], (size_t)len[v] * sizeof(uint16_t));
+        }
+    }
+    for (int v = 0; v < n; ++v) { free(hub[v]); free(hd[v]); }
+    free(hub);
+    free(hd);
+    free(len);
+    free(cap);
+    free(root_d);
+    free(dist);
+    free(queue);
+    free(order);
+    return o;
+}
+
+// Distance bounds for s -> t: returns the upper bound and sets *lower.
+// Both are -1 when s and t are known to be disconnected; the upper bound is
+// (int)INF when no landmark reaches either. PLL answers are exact (lower == upper).
+int oracle_query(const DistOracle* o, int s, int t, int* lower) {
+    if (s == t) { *lower = 0; return 0; }
+    if (o->pll) {
+        int64_t i = o->label_off[s], ie = o->label_off[s + 1];
+        int64_t j = o->label_off[t], je = o->label_off[t + 1];
+        int best = -1;
+        while (i < ie && j < je) {
+            int hi = o->label_hub[i], hj = o->label_hub[j];
+            if (hi == hj) {
+                int d = o->label_dist[i++] + o->label_dist[j++];
+                if (best < 0 || d < best) best = d;
+            }
+            else if (hi < hj) ++i;
+            else ++j;
+        }
+        *lower = best;
+        return best;
+    }
+    const uint16_t* ds = o->dist + (size_t)s * o->k;
+    const uint16_t* dt = o->dist + (size_t)t * o->k;
+    int lo = 0, hi = (int)INF;
+    for (int i = 0; i < o->k; ++i) {
+        int a = ds[i], b = dt[i];
+        if (a == LM_FAR && b == LM_FAR) continue;
+        if (a == LM_FAR || b == LM_FAR) { *lower = -1; return -1; }   // one side only: other component
+        if (a + b < hi) hi = a + b;
+        if (a - b > lo) lo = a - b;
+        if (b - a > lo) lo = b - a;
+    }
+    *lower = lo;
+    return hi;
+}
+
+size_t oracle_bytes(const DistOracle* o) {
+    if (o->pll) return ((size_t)o->n + 1) * sizeof(int64_t)
+        + (size_t)o->label_off[o->n] * (sizeof(int) + sizeof(uint16_t));
+    return (size_t)o->k * sizeof(int) + (size_t)o->n * o->k * sizeof(uint16_t);
+}
+
+// File: "HWORACL\0", uint32 version, uint32 pll, uint64 n, uint64 k (landmarks)
+// or label entries (PLL), then landmarks[k] + dist[n*k] or
+// label_off[n+1] + label_hub[entries] + label_dist[entries]; native byte order
+int oracle_save(const DistOracle* o, const char* path) {
+    FILE* fp = fopen(path, "wb");
+    if (!fp) { perror(path); return 1; }
+    uint32_t version = 1, pll = (uint32_t)o->pll;
+    uint64_t n = (uint64_t)o->n, k = o->pll ? (uint64_t)o->label_off[o->n] : (uint64_t)o->k;
+    int ok = fwrite("HWORACL", 1, 8, fp) == 8 && fwrite(&version, 4, 1, fp) == 1
+        && fwrite(&pll, 4, 1, fp) == 1 && fwrite(&n, 8, 1, fp) == 1 && fwrite(&k, 8, 1, fp) == 1;
+    if (ok && o->pll)
+        ok = fwrite(o->label_off, sizeof(int64_t), (size_t)n + 1, fp) == (size_t)n + 1
+            && fwrite(o->label_hub, sizeof(int), (size_t)k, fp) == (size_t)k
+            && fwrite(o->label_dist, sizeof(uint16_t), (size_t)k, fp) == (size_t)k;
+    else if (ok)
+        ok = fwrite(o->landmarks, sizeof(int), (size_t)k, fp) == (size_t)k
+            && fwrite(o->dist, sizeof(uint16_t), (size_t)(n * k), fp) == (size_t)(n * k);
+    ok &= fclose(fp) == 0;
+    if (!ok) fprintf(stderr, "%s: write failed\n", path);
+    return ok ? 0 : 1;
+}
+
+DistOracle* oracle_load(const char* path) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) { perror(path); return NULL; }
+    char magic[8];
+    uint32_t version, pll;
+    uint64_t n, k;
+    DistOracle* o = NULL;
+    if (fread(magic, 1, 8, fp) == 8 && memcmp(magic, "HWORACL", 8) == 0 && fread(&version, 4, 1, fp) == 1
+        && version == 1 && fread(&pll, 4, 1, fp) == 1 && fread(&n, 8, 1, fp) == 1 && fread(&k, 8, 1, fp) == 1
+        && n < (uint64_t)INT32_MAX && (pll ? k <= (uint64_t)PLL_MAX_ENTRIES : k <= n)) {
+        o = oracle_alloc((int)n);
+        o->pll = (int)pll;
+        int ok;
+        if (pll) {
+            o->label_off = (int64_t*)malloc(((size_t)n + 1) * sizeof(int64_t));
+            o->label_hub = (int*)malloc((size_t)k * sizeof(int) + sizeof(int));
+            o->label_dist = (uint16_t*)malloc((size_t)k * sizeof(uint16_t) + sizeof(uint16_t));
+            ok = fread(o->label_off, sizeof(int64_t), (size_t)n + 1, fp) == (size_t)n + 1
+                && fread(o->label_hub, sizeof(int), (size_t)k, fp) == (size_t)k
+                && fread(o->label_dist, sizeof(uint16_t), (size_t)k, fp) == (size_t)k
+                && o->label_off[0] == 0 && (uint64_t)o->label_off[n] == k;
+            for (uint64_t v = 0; ok && v < n; ++v) ok = o->label_off[v] <= o->label_off[v + 1];
+        }
+        else {
+            o->k = (int)k;
+            o->landmarks = (int*)malloc((size_t)k * sizeof(int) + sizeof(int));
+            o->dist = (uint16_t*)malloc((size_t)(n * k) * sizeof(uint16_t) + sizeof(uint16_t));
+            ok = fread(o->landmarks, sizeof(int), (size_t)k, fp) == (size_t)k
+                && fread(o->dist, sizeof(uint16_t), (size_t)(n * k), fp) == (size_t)(n * k);
+        }
+        if (!ok) { oracle_free(o); o = NULL; }
+    }
+    fclose(fp);
+    if (!o) fprintf(stderr, "%s: not a distance oracle file or truncated\n", path);
+    return o;
+}
+
+// Build (or load) an oracle, time random queries and score them against
+// bidirectional BFS. kind: "degree" / "random" landmarks, or "pll".
+// With index_path the index is saved there and the timed copy is the reloaded one.
+int run_oracle_benchmark(const Graph* g, const char* kind, int k, const char* index_path) {
+    int n = g->n, pll = strcmp(kind, "pll") == 0;
+    if (!pll && (k < 1 || (strcmp(kind, "degree") != 0 && strcmp(kind, "random") != 0))) {
+        fprintf(stderr, "usage: hw7 oracle n m | grid side | file.bin [degree|random|pll] [k >= 1] [index]\n");
+        return 1;
+    }
+    printf("Distance oracle: n=%d, edges=%lld, %s", n, g->m / 2, pll ? "pruned landmark labeling\n" : "");
+    if (!pll) printf("%d %s landmarks\n", k, strcmp(kind, "random") == 0 ? "random" : "top-degree");
+
+    double t0 = now_seconds();
+    DistOracle* o = pll ? oracle_build_pll(g) : oracle_build_landmarks(g, k, strcmp(kind, "random") == 0);
+    if (!o) return 1;
+    printf("Build: %.3f s, index %zu Bytes", now_seconds() - t0, oracle_bytes(o));
+    if (pll) printf(", %.1f label entries per vertex", (double)o->label_off[n] / (n ? n : 1));
+    printf("\n");
+    if (index_path) {
+        if (oracle_save(o, index_path)) { oracle_free(o); return 1; }
+        oracle_free(o);
+        t0 = now_seconds();
+        o = oracle_load(index_path);
+        if (!o) return 1;
+        printf("Saved to %s, reloaded in %.3f s\n", index_path, now_seconds() - t0);
+    }
+
+    int Q = 1000000, sample = n < 2000 ? n : 2000;
+    int* qs = (int*)malloc((size_t)Q * sizeof(int));
+    int* qt = (int*)malloc((size_t)Q * sizeof(int));
+    uint64_t seed = (uint64_t)time(NULL) ^ 0x4F52434CULL;
+    for (int i = 0; i < Q; ++i) {
+        qs[i] = (int)(rng_next(&seed) % (uint64_t)n);
+        qt[i] = (int)(rng_next(&seed) % (uint64_t)n);
+    }
+    long long checksum = 0;
+    t0 = now_seconds();
+    for (int i = 0; i < Q; ++i) {
+        int lo, hi = oracle_query(o, qs[i], qt[i], &lo);
+        checksum += hi + lo;
+    }
+    double t_q = now_seconds() - t0;
+    printf("Queries: %.3f us/query over %d random pairs (checksum %lld)\n", t_q * 1e6 / Q, Q, checksum);
+
+    // accuracy against exact hops from bidirectional BFS
+    BiBfs* w = bibfs_create(n);
+    int valid = 1, exact = 0, certified = 0, reachable = 0;
+    double ratio = 0, t_bi = 0;
+    for (int i = 0; i < sample; ++i) {
+        int lo, hi = oracle_query(o, qs[i], qt[i], &lo);
+        t0 = now_seconds();
+        int d = bibfs_query(g, w, qs[i], qt[i], NULL);
+        t_bi += now_seconds() - t0;
+        if (d < 0) { valid &= hi < 0 || hi == (int)INF; continue; }
+        reachable++;
+        valid &= lo >= 0 && lo <= d && d <= hi;
+        exact += hi == d;
+        certified += lo == hi;
+        if (hi != (int)INF) ratio += d ? (double)hi / d : 1.0;
+    }
+    if (sample) printf("Bidirectional BFS: %.2f us/query\n", t_bi * 1e6 / sample);
+    if (reachable)
+        printf("On %d reachable pairs: upper bound exact %.1f%%, certified (lower == upper) %.1f%%, mean upper/true %.3f\n",
+            reachable, 100.0 * exact / reachable, 100.0 * certified / reachable, ratio / reachable);
+    if (pll) valid &= exact == reachable;
+    printf("Bounds consistent with BFS%s: %s\n", pll ? " (all exact)" : "", valid ? "yes" : "NO");
+    bibfs_free(w);
+    free(qs);
+    free(qt);
+    oracle_free(o);
+    return valid ? 0 : 1;
+}
+
+/* ---------- Weighted shortest paths ---------- */
+
+// Random integer weights in [1, max_w], the same on both arcs of an edge:
+// the weight is a hash of the (min, max) endpoint pair
+void graph_set_weights(Graph* g, int max_w, uint64_t seed) {
+    if (g->file) {   // mapped read-only: switch to a private weights array
+        g->weights = (int*)malloc((size_t)g->m * sizeof(int) + sizeof(int));
+        g->offsets = (int64_t*)memcpy(malloc(((size_t)g->n + 1) * sizeof(int64_t)), g->offsets, ((size_t)g->n + 1) * sizeof(int64_t));
+        g->nbrs = (int*)memcpy(malloc((size_t)g->m * sizeof(int) + sizeof(int)), g->nbrs, (size_t)g->m * sizeof(int));
+        gf_close(g->file);
+        free(g->file);
+        g->file = NULL;
+    }
+    else if (!g->weights) g->weights = (int*)malloc((size_t)g->m * sizeof(int) + sizeof(int));
+    for (int u = 0; u < g->n; ++u)
+        for (int64_t e = g->offsets[u]; e < g->offsets[u + 1]; ++e) {
+            int v = g->nbrs[e];
+            uint64_t h = seed ^ ((uint64_t)(u < v ? u : v) << 32 | (uint32_t)(u < v ? v : u));
+            g->weights[e] = max_w <= 1 ? 1 : 1 + (int)(rng_next(&h) % (uint64_t)max_w);
+        }
+}
+
+// Dijkstra with lazy deletion: stale entries (key > dist[v]) are skipped on
+// pop, so a queue needs only push / pop-min. PqOps makes the queue pluggable.
+typedef struct {
+    int64_t key;
+    int v;
+} PqItem;
+
+typedef struct {
+    PqItem* a;
+    int64_t size, cap;
+    // radix heap only
+    PqItem* bucket[65];
+    int64_t bsize[65], bcap[65];
+    int64_t last;           // last popped key; every key in bucket i differs from it first at bit i-1
+} PQueue;
+
+typedef struct {
+    const char* name;
+    void (*push)(PQueue* q, int64_t key, int v);
+    PqItem (*pop)(PQueue* q);     // only when size > 0
+} PqOps;
+
+void pq_reset(PQueue* q) {
+    q->size = 0;
+    q->last = 0;
+    for (int i = 0; i < 65; ++i) q->bsize[i] = 0;
+}
+
+void pq_free(PQueue* q) {
+    free(q->a);
+    for (int i = 0; i < 65; ++i) free(q->bucket[i]);
+}
+
+void pq_grow(PqItem** a, int64_t* cap, int64_t need) {
+    if (need <= *cap) return;
+    *cap = *cap ? *cap * 2 : 256;
+    if (*cap < need) *cap = need;
+    *a = (PqItem*)realloc(*a, (size_t)*cap * sizeof(PqItem));
+}
+
+// d-ary min-heap in a[0 .. size); arity is a constant in each wrapper below
+void dheap_push(PQueue* q, int64_t key, int v, int arity) {
+    pq_grow(&q->a, &q->cap, q->size + 1);
+    int64_t i = q->size++;
+    while (i > 0) {
+        int64_t p = (i - 1) / arity;
+        if (q->a[p].key <= key) break;
+        q->a[i] = q->a[p];
+        i = p;
+    }
+    q->a[i].key = key;
+    q->a[i].v = v;
+}
+
+PqItem dheap_pop(PQueue* q, int arity) {
+    PqItem top = q->a[0], x = q->a[--q->size];
+    int64_t i = 0, n = q->size;
+    for (;;) {
+        int64_t c = i * arity + 1, best = c;
+        if (c >= n) break;
+        for (int64_t j = c + 1; j < c + arity && j < n; ++j)
+            if (q->a[j].key < q->a[best].key) best = j;
+        if (q->a[best].key >= x.key) break;
+        q->a[i] = q->a[best];
+        i = best;
+    }
+    if (n) q->a[i] = x;
+    return top;
+}
+
+void binheap_push(PQueue* q, int64_t key, int v) { dheap_push(q, key, v, 2); }
+PqItem binheap_pop(PQueue* q) { return dheap_pop(q, 2); }
+void quadheap_push(PQueue* q, int64_t key, int v) { dheap_push(q, key, v, 4); }
+PqItem quadheap_pop(PQueue* q) { return dheap_pop(q, 4); }
+
+// 1-based index of the highest set bit, 0 for 0
+int bit_width64(uint64_t x) {
+#ifdef _MSC_VER
+    unsigned long i;
+    return _BitScanReverse64(&i, x) ? (int)i + 1 : 0;
+#else
+    return x ? 64 - __builtin_clzll(x) : 0;
+#endif
+}
+
+// Radix heap (Ahuja et al.): keys never drop below the last popped key, so a
+// key sits in bucket bit_width(key ^ last). Popping from an empty bucket 0
+// moves the smallest key of the first non-empty bucket into last and
+// redistributes that bucket; each item moves down at most 64 times.
+void radix_push(PQueue* q, int64_t key, int v) {
+    int b = bit_width64((uint64_t)(key ^ q->last));
+    pq_grow(&q->bucket[b], &q->bcap[b], q->bsize[b] + 1);
+    q->bucket[b][q->bsize[b]].key = key;
+    q->bucket[b][q->bsize[b]++].v = v;
+    q->size++;
+}
+
+PqItem radix_pop(PQueue* q) {
+    if (q->bsize[0] == 0) {
+        int b = 1;
+        while (q->bsize[b] == 0) ++b;
+        int64_t m = q->bucket[b][0].key;
+        for (int64_t i = 1; i < q->bsize[b]; ++i)
+            if (q->bucket[b][i].key < m) m = q->bucket[b][i].key;
+        q->last = m;
+        int64_t cnt = q->bsize[b];
+        q->bsize[b] = 0;
+        q->size -= cnt;
+        for (int64_t i = 0; i < cnt; ++i) radix_push(q, q->bucket[b][i].key, q->bucket[b][i].v);
+    }
+    q->size--;
+    return q->bucket[0][--q->bsize[0]];
+}
+
+const PqOps pq_ops[] = {
+    { "binary heap", binheap_push, binheap_pop },
+    { "4-ary heap", quadheap_push, quadheap_pop },
+    { "radix heap", radix_push, radix_pop },
+};
+#define PQ_KINDS ((int)(sizeof(pq_ops) / sizeof(pq_ops[0])))
+
+// Single-source shortest paths on g->weights (all 1 when NULL). Unreached
+// vertices keep dist = WDIST_INF and prev = -1. Returns the settled count;
+// *pops (if non-NULL) receives the queue pops including stale ones.
+int dijkstra(const Graph* g, int s, int64_t* dist, int* prev, const PqOps* ops, PQueue* q, long long* pops) {
+    int settled = 0;
+    long long popped = 0;
+    for (int v = 0; v < g->n; ++v) {
+        dist[v] = WDIST_INF;
+        prev[v] = -1;
+    }
+    pq_reset(q);
+    dist[s] = 0;
+    ops->push(q, 0, s);
+    while (q->size > 0) {
+        PqItem it = ops->pop(q);
+        popped++;
+        if (it.key > dist[it.v]) continue;
+        int u = it.v;
+        settled++;
+        for (int64_t e = g->offsets[u]; e < g->offsets[u + 1]; ++e) {
+            int v = g->nbrs[e];
+            int64_t nd = it.key + (g->weights ? g->weights[e] : 1);
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                prev[v] = u;
+                ops->push(q, nd, v);
+            }
+        }
+    }
+    if (pops) *pops = popped;
+    return settled;
+}
+
+// returns the value seen at *p; the swap happened iff that equals expected
+int64_t atomic_cas_int64(volatile int64_t* p, int64_t expected, int64_t desired) {
+#ifdef _MSC_VER
+    return _InterlockedCompareExchange64((volatile long long*)p, desired, expected);
+#else
+    return __sync_val_compare_and_swap(p, expected, desired);
+#endif
+}
+
+// Delta-stepping (Meyer and Sanders): bucket i holds vertices with tentative
+// distance in [i*delta, (i+1)*delta). The current bucket is settled in phases
+// that relax light edges (w <= delta) of its vertices in parallel, lowering
+// dist with a CAS-min, until it stays empty; heavy edges of everything the
+// bucket settled are relaxed once afterwards. Relaxed vertices are collected
+// per thread and filed into buckets between phases; stale bucket entries are
+// skipped. prev is derived at the end (first neighbor on a shortest path in
+// adjacency order), so it does not depend on the thread schedule.
+int delta_stepping(const Graph* g, int s, int64_t* dist, int* prev, int64_t delta) {
+    int n = g->n, T = max_threads(), settled = 0;
+    int64_t nb = 0, bcap = 0;
+    int** bucket = NULL;                       // bucket[i][0 .. bsize[i])
+    int64_t *bsize = NULL, *bcapv = NULL;
+    int* stamp = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));   // last phase that took v
+    int* frontier = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int* done = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));  // settled in the current bucket
+    int64_t* done_in = (int64_t*)malloc((size_t)n * sizeof(int64_t) + sizeof(int64_t));   // bucket that settled v
+    int** out = (int**)malloc((size_t)T * sizeof(int*));               // per-thread relaxed vertices
+    int64_t* out_n = (int64_t*)calloc((size_t)T, sizeof(int64_t));
+    int64_t* out_cap = (int64_t*)calloc((size_t)T, sizeof(int64_t));
+    for (int t = 0; t < T; ++t) out[t] = NULL;
+
+#pragma omp parallel for
+    for (int v = 0; v < n; ++v) {
+        dist[v] = WDIST_INF;
+        stamp[v] = -1;
+        done_in[v] = -1;
+    }
+    dist[s] = 0;
+    // file v into the bucket of its current distance
+#define DS_FILE(v) do {                                                          \
+        int64_t b_ = dist[v] / delta;                                            \
+        if (b_ >= bcap) {                                                        \
+            int64_t nc_ = bcap ? bcap * 2 : 64;                                  \
+            while (nc_ <= b_) nc_ *= 2;                                          \
+            bucket = (int**)realloc(bucket, (size_t)nc_ * sizeof(int*));         \
+            bsize = (int64_t*)realloc(bsize, (size_t)nc_ * sizeof(int64_t));     \
+            bcapv = (int64_t*)realloc(bcapv, (size_t)nc_ * sizeof(int64_t));     \
+            for (int64_t i_ = bcap; i_ < nc_; ++i_) { bucket[i_] = NULL; bsize[i_] = bcapv[i_] = 0; } \
+            bcap = nc_;                                                          \
+        }                                                                        \
+        if (b_ >= nb) nb = b_ + 1;                                               \
+        if (bsize[b_] == bcapv[b_]) {                                            \
+            bcapv[b_] = bcapv[b_] ? bcapv[b_] * 2 : 16;                          \
+            bucket[b_] = (int*)realloc(bucket[b_], (size_t)bcapv[b_] * sizeof(int)); \
+        }                                                                        \
+        bucket[b_][bsize[b_]++] = (v);                                           \
+    } while (0)
+    DS_FILE(s);
+
+    int phase = 0;
+    for (int64_t cur = 0; cur < nb; ++cur) {
+        int ndone = 0;
+        for (int heavy = 0; heavy < 2; ++heavy) {
+            for (;;) {
+                int nf = 0;
+                if (!heavy) {   // live, not yet taken entries of the bucket
+                    for (int64_t i = 0; i < bsize[cur]; ++i) {
+                        int v = bucket[cur][i];
+                        if (dist[v] / delta != cur || stamp[v] == phase) continue;
+                        stamp[v] = phase;
+                        frontier[nf++] = v;
+                    }
+                    bsize[cur] = 0;
+                    if (nf == 0) break;
+                    for (int i = 0; i < nf; ++i)   // settled in this bucket, once each
+                        if (done_in[frontier[i]] != cur) {
+                            done_in[frontier[i]] = cur;
+                            done[ndone++] = frontier[i];
+                        }
+                    phase++;
+                }
+                const int* src = heavy ? done : frontier;
+                int cnt = heavy ? ndone : nf;
+#pragma omp parallel
+                {
+#ifdef _OPENMP
+                    int t = omp_get_thread_num();
+#else
+                    int t = 0;
+#endif
+                    out_n[t] = 0;
+#pragma omp for schedule(dynamic, 64)
+                    for (int i = 0; i < cnt; ++i) {
+                        int u = src[i];
+                        int64_t du = dist[u];
+                        for (int64_t e = g->offsets[u]; e < g->offsets[u + 1]; ++e) {
+                            int w = g->weights ? g->weights[e] : 1;
+                            if ((w > delta) != heavy) continue;
+                            int v = g->nbrs[e];
+                            int64_t nd = du + w, cur_d = dist[v];
+                            while (nd < cur_d) {
+                                int64_t seen = atomic_cas_int64(&dist[v], cur_d, nd);
+                                if (seen == cur_d) {
+                                    if (out_n[t] == out_cap[t]) {
+                                        out_cap[t] = out_cap[t] ? out_cap[t] * 2 : 1024;
+                                        out[t] = (int*)realloc(out[t], (size_t)out_cap[t] * sizeof(int));
+                                    }
+                                    out[t][out_n[t]++] = v;
+                                    break;
+                                }
+                                cur_d = seen;
+                            }
+                        }
+                    }
+                }
+                for (int t = 0; t < T; ++t)
+                    for (int64_t i = 0; i < out_n[t]; ++i) DS_FILE(out[t][i]);
+                if (heavy) break;
+            }
+        }
+        settled += ndone;
+        free(bucket[cur]);   // never refilled: distances only grow past cur from here
+        bucket[cur] = NULL;
+        bcapv[cur] = 0;
+    }
+#undef DS_FILE
+
+    // prev from the final distances
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int v = 0; v < n; ++v) {
+        prev[v] = -1;
+        if (v == s || dist[v] == WDIST_INF) continue;
+        for (int64_t e = g->offsets[v]; e < g->offsets[v + 1]; ++e) {
+            int u = g->nbrs[e];
+            if (dist[u] != WDIST_INF && dist[u] + (g->weights ? g->weights[e] : 1) == dist[v]) { prev[v] = u; break; }
+        }
+    }
+    for (int64_t i = 0; i < bcap; ++i) free(bucket[i]);
+    free(bucket);
+    free(bsize);
+    free(bcapv);
+    for (int t = 0; t < T; ++t) free(out[t]);
+    free(out);
+    free(out_n);
+    free(out_cap);
+    free(stamp);
+    free(frontier);
+    free(done);
+    free(done_in);
+    return settled;
+}
+
+// Dijkstra with every queue plus delta-stepping on random weights in
+// [1, max_w] (or the file's own weights), then all of them against plain BFS
+// with every weight set to 1
+int run_sssp_benchmark(Graph* g, int max_w, int sources) {
+    int n = g->n, same = 1, done = 0;
+    int64_t* dist = (int64_t*)malloc((size_t)n * sizeof(int64_t) + sizeof(int64_t));
+    int64_t* dist2 = (int64_t*)malloc((size_t)n * sizeof(int64_t) + sizeof(int64_t));
+    int* prev = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int* bdist = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+    int* src = (int*)malloc((size_t)sources * sizeof(int) + sizeof(int));
+    uint64_t seed = (uint64_t)time(NULL) ^ 0x53535350ULL;
+    PQueue q;
+    memset(&q, 0, sizeof(q));
+    for (int k = 0; k < sources * 100 && done < sources; ++k) {
+        int s = (int)(rng_next(&seed) % (uint64_t)n);
+        if (graph_degree(g, s) > 0) src[done++] = s;
+    }
+    sources = done;
+
+    for (int uniform = 0; uniform < 2; ++uniform) {
+        if (uniform) graph_set_weights(g, 1, 0);
+        else if (!g->weights) graph_set_weights(g, max_w, seed);
+        else max_w = 0;   // weights from the graph file
+        int64_t w_max = 1, w_sum = 0;
+        for (int64_t e = 0; e < g->m; ++e) {
+            w_sum += g->weights[e];
+            if (g->weights[e] > w_max) w_max = g->weights[e];
+        }
+        // delta ~ max weight / average degree: about one bucket's worth of light edges per vertex
+        int64_t delta = g->m ? w_max * n / g->m : 1;
+        if (delta < 1) delta = 1;
+        if (uniform) printf("\nUniform weights (all 1), vs BFS:\n");
+        else printf("SSSP: n=%d, edges=%lld, %d sources, weights %s%d, mean %.1f\n", n, g->m / 2, sources,
+            max_w ? "1.." : "from file, max ", max_w ? max_w : (int)w_max, g->m ? (double)w_sum / g->m : 0.0);
+
+        double t_ref = 0;
+        if (uniform) {
+            for (int k = 0; k < sources; ++k) {
+                double t0 = now_seconds();
+                bfs_csr(g, src[k], bdist, prev, 0, NULL);
+                t_ref += now_seconds() - t0;
+            }
+            printf("  %-22s %9.3f ms/source\n", "BFS (top-down)", t_ref * 1e3 / (sources ? sources : 1));
+        }
+        for (int kind = 0; kind <= PQ_KINDS; ++kind) {
+            double t = 0;
+            long long pops = 0, p;
+            for (int k = 0; k < sources; ++k) {
+                double t0 = now_seconds();
+                if (kind < PQ_KINDS) dijkstra(g, src[k], dist2, prev, &pq_ops[kind], &q, &p);
+                else delta_stepping(g, src[k], dist2, prev, delta);
+                t += now_seconds() - t0;
+                if (kind < PQ_KINDS) pops += p;
+                // reference: binary-heap Dijkstra (and BFS when uniform)
+                dijkstra(g, src[k], dist, prev, &pq_ops[0], &q, NULL);
+                same &= memcmp(dist, dist2, (size_t)n * sizeof(int64_t)) == 0;
+                if (uniform) {
+                    bfs_csr(g, src[k], bdist, prev, 0, NULL);
+                    for (int v = 0; v < n; ++v)
+                        same &= bdist[v] == (int)INF ? dist2[v] == WDIST_INF : dist2[v] == bdist[v];
+                }
+            }
+            char label[64];
+            if (kind < PQ_KINDS) snprintf(label, sizeof(label), "Dijkstra, %s", pq_ops[kind].name);
+            else snprintf(label, sizeof(label), "Delta-stepping d=%lld", (long long)delta);
+            printf("  %-22s %9.3f ms/source", label, t * 1e3 / (sources ? sources : 1));
+            if (kind < PQ_KINDS) printf("  %6.2f pops/vertex", (double)pops / (sources ? sources : 1) / n);
+            if (uniform) printf("  (%.2fx BFS)", t_ref > 0 ? t / t_ref : 0.0);
+            printf("\n");
+        }
+    }
+    printf("Distances identical across queues, delta-stepping and BFS: %s\n", same ? "yes" : "NO");
+    pq_free(&q);
+    free(dist);
+    free(dist2);
+    free(prev);
+    free(bdist);
+    free(src);
+    return same ? 0 : 1;
+}
+
+/* ---------- Bitset BFS for small graphs ---------- */
+
+// Graphs of at most V <= 64 * W vertices: row[u] is the W-word neighbor
+// bitset of u, so a BFS level is the OR of the frontier's rows with the
+// visited bits masked off. BITGRAPH(T, p, V, W) stamps out type T and its
+// p_ functions for one size, so every word loop has a constant trip count.
+#define BITGRAPH(T, p, V, W)                                                         \
+typedef struct {                                                                     \
+    int n;                                                                           \
+    uint64_t row[V][W];                                                              \
+} T;                                                                                 \
+                                                                                     \
+/* g->n must be <= V */                                                              \
+void p##_from_csr(T* b, const Graph* g) {                                            \
+    memset(b, 0, sizeof(*b));                                                        \
+    b->n = g->n;                                                                     \
+    for (int u = 0; u < g->n; ++u)                                                   \
+        for (int64_t e = g->offsets[u]; e < g->offsets[u + 1]; ++e)                 \
+            b->row[u][g->nbrs[e] >> 6] |= 1ULL << (g->nbrs[e] & 63);                \
+}                                                                                    \
+                                                                                     \
+/* dist[v] = hops from s (-1 unreachable); returns the number reached */            \
+int p##_bfs(const T* b, int s, int* dist) {                                         \
+    uint64_t visited[W] = { 0 }, frontier[W] = { 0 };                                \
+    int reached = 1;                                                                 \
+    for (int v = 0; v < b->n; ++v) dist[v] = -1;                                     \
+    visited[s >> 6] = frontier[s >> 6] = 1ULL << (s & 63);                           \
+    dist[s] = 0;                                                                     \
+    for (int level = 1;; ++level) {                                                  \
+        uint64_t next[W] = { 0 }, any = 0;                                           \
+        for (int w = 0; w < (W); ++w)                                                \
+            for (uint64_t f = frontier[w]; f; f &= f - 1) {                          \
+                const uint64_t* r = b->row[w * 64 + ctz64(f)];                       \
+                for (int k = 0; k < (W); ++k) next[k] |= r[k];                       \
+            }                                                                        \
+        for (int k = 0; k < (W); ++k) {                                              \
+            next[k] &= ~visited[k];                                                  \
+            visited[k] |= next[k];                                                   \
+            frontier[k] = next[k];                                                   \
+            any |= next[k];                                                          \
+            for (uint64_t f = next[k]; f; f &= f - 1) { dist[k * 64 + ctz64(f)] = level; reached++; } \
+        }                                                                            \
+        if (!any) return reached;                                                    \
+    }                                                                                \
+}                                                                                    \
+                                                                                     \
+/* hops s -> t (-1 unreachable), stopping at the level that reaches t */            \
+int p##_hops(const T* b, int s, int t) {                                            \
+    uint64_t visited[W] = { 0 }, frontier[W] = { 0 };                                \
+    if (s == t) return 0;                                                            \
+    visited[s >> 6] = frontier[s >> 6] = 1ULL << (s & 63);                           \
+    for (int level = 1;; ++level) {                                                  \
+        uint64_t next[W] = { 0 }, any = 0;                                           \
+        for (int w = 0; w < (W); ++w)                                                \
+            for (uint64_t f = frontier[w]; f; f &= f - 1) {                          \
+                const uint64_t* r = b->row[w * 64 + ctz64(f)];                       \
+                for (int k = 0; k < (W); ++k) next[k] |= r[k];                       \
+            }                                                                        \
+        for (int k = 0; k < (W); ++k) {                                              \
+            next[k] &= ~visited[k];                                                  \
+            visited[k] |= next[k];                                                   \
+            frontier[k] = next[k];                                                   \
+            any |= next[k];                                                          \
+        }                                                                            \
+        if (next[t >> 6] >> (t & 63) & 1) return level;                              \
+        if (!any) return -1;                                                         \
+    }                                                                                \
+}
+
+BITGRAPH(BitGraph1, bitgraph1, 64, 1)
+BITGRAPH(BitGraph2, bitgraph2, 128, 2)
+BITGRAPH(BitGraph4, bitgraph4, 256, 4)
+BITGRAPH(BitGraphN, bitgraphN, N, (N + 63) / 64)   // sized for the demo graph at compile time
+#undef BITGRAPH
+
+// Bitset BFS vs CSR BFS on many random small graphs of 64, 128 and 256
+// vertices (average degree deg), all sources; then s-t hop queries.
+// Also checks the N-vertex demo graph through BitGraphN.
+int run_smallbfs_benchmark(double deg, int graphs) {
+    uint64_t seed = (uint64_t)time(NULL);
+    int same = 1;
+    long long check = 0;   // consumes the timed results
+    int* dist = (int*)malloc(256 * sizeof(int));
+    int* dist2 = (int*)malloc(256 * sizeof(int));
+    int* prev = (int*)malloc(256 * sizeof(int));
+    BitGraph1* b1 = (BitGraph1*)malloc(sizeof(BitGraph1));
+    BitGraph2* b2 = (BitGraph2*)malloc(sizeof(BitGraph2));
+    BitGraph4* b4 = (BitGraph4*)malloc(sizeof(BitGraph4));
+
+    {
+        BitGraphN* bn = (BitGraphN*)malloc(sizeof(BitGraphN));
+        int dist_n[N], prev_n[N];
+        make_random_graph((unsigned int)seed);
+        Graph* g = graph_from_matrix();
+        bitgraphN_from_csr(bn, g);
+        for (int s = 0; s < N; ++s) {
+            bfs(s, dist_n, prev_n);
+            bitgraphN_bfs(bn, s, dist);
+            for (int v = 0; v < N; ++v) same &= dist[v] == (dist_n[v] == (int)INF ? -1 : dist_n[v]);
+        }
+        printf("Demo graph (N=%d, %zu-Byte bitset graph vs %zu-Byte adj matrix): %s\n",
+            N, sizeof(BitGraphN), sizeof(adj), same ? "same distances" : "MISMATCH");
+        graph_free(g);
+        free(bn);
+    }
+
+    printf("Small-graph BFS: %d random graphs per size, average degree %.1f\n", graphs, deg);
+    printf("%6s %14s %14s %8s %14s\n", "n", "CSR ns/BFS", "bitset ns/BFS", "speedup", "hops ns/query");
+    for (int W = 1; W <= 4; W *= 2) {
+        int n = 64 * W;
+        long long E = (long long)(deg * n / 2);
+        double t_csr = 0, t_bit = 0, t_hops = 0;
+        long long bfs_runs = 0, queries = 0;
+        for (int k = 0; k < graphs; ++k) {
+            Graph* g = graph_random(n, E, rng_next(&seed));
+            if (W == 1) bitgraph1_from_csr(b1, g);
+            else if (W == 2) bitgraph2_from_csr(b2, g);
+            else bitgraph4_from_csr(b4, g);
+
+            double t0 = now_seconds();
+            for (int s = 0; s < n; ++s) {
+                bfs_csr(g, s, dist2, prev, 0, NULL);
+                check += dist2[n - 1 - s];
+            }
+            t_csr += now_seconds() - t0;
+            t0 = now_seconds();
+            for (int s = 0; s < n; ++s) {
+                if (W == 1) bitgraph1_bfs(b1, s, dist);
+                else if (W == 2) bitgraph2_bfs(b2, s, dist);
+                else bitgraph4_bfs(b4, s, dist);
+                check += dist[n - 1 - s];
+            }
+            t_bit += now_seconds() - t0;
+            bfs_runs += n;
+
+            t0 = now_seconds();
+            for (int s = 0; s < n; ++s)
+                for (int t = 0; t < n; t += 7) {
+                    check += W == 1 ? bitgraph1_hops(b1, s, t) : W == 2 ? bitgraph2_hops(b2, s, t) : bitgraph4_hops(b4, s, t);
+                    queries++;
+                }
+            t_hops += now_seconds() - t0;
+
+            for (int s = 0; s < n; s += 5) {   // correctness against the CSR BFS
+                bfs_csr(g, s, dist2, prev, 0, NULL);
+                if (W == 1) bitgraph1_bfs(b1, s, dist);
+                else if (W == 2) bitgraph2_bfs(b2, s, dist);
+                else bitgraph4_bfs(b4, s, dist);
+                for (int t = 0; t < n; ++t) {
+                    int want = dist2[t] == (int)INF ? -1 : dist2[t];
+                    int hops = W == 1 ? bitgraph1_hops(b1, s, t) : W == 2 ? bitgraph2_hops(b2, s, t) : bitgraph4_hops(b4, s, t);
+                    same &= dist[t] == want && hops == want;
+                }
+            }
+            graph_free(g);
+        }
+        printf("%6d %14.1f %14.1f %7.1fx %14.1f\n", n, t_csr * 1e9 / bfs_runs, t_bit * 1e9 / bfs_runs,
+            t_bit > 0 ? t_csr / t_bit : 0.0, t_hops * 1e9 / queries);
+    }
+    printf("Bitset distances and hop queries match CSR BFS: %s (checksum %lld)\n", same ? "yes" : "NO", check);
+    free(dist);
+    free(dist2);
+    free(prev);
+    free(b1);
+    free(b2);
+    free(b4);
+    return same ? 0 : 1;
+}
+
+/* ---------- Betweenness centrality ---------- */
+
+// Brandes: one BFS per source counts shortest paths (sigma), then vertices
+// are revisited in reverse BFS order to accumulate dependencies. Predecessors
+// are not stored: w's predecessors are its neighbors one level closer.
+// Only vertices the BFS reached are reset, so a small component costs little.
+void brandes_source(const Graph* g, int s, int* dist, double* sigma, double* delta, int* order, double* bc) {
+    int head = 0, tail = 0;
+    dist[s] = 0;
+    sigma[s] = 1;
+    order[tail++] = s;
+    while (head < tail) {
+        int u = order[head++];
+        for (int64_t e = g->offsets[u]; e < g->offsets[u + 1]; ++e) {
+            int v = g->nbrs[e];
+            if (dist[v] < 0) {
+                dist[v] = dist[u] + 1;
+                order[tail++] = v;
+            }
+            if (dist[v] == dist[u] + 1) sigma[v] += sigma[u];
+        }
+    }
+    for (int i = tail - 1; i > 0; --i) {
+        int w = order[i];
+        double coeff = (1 + delta[w]) / sigma[w];
+        for (int64_t e = g->offsets[w]; e < g->offsets[w + 1]; ++e) {
+            int v = g->nbrs[e];
+            if (dist[v] == dist[w] - 1) delta[v] += sigma[v] * coeff;
+        }
+        bc[w] += delta[w];
+    }
+    for (int i = 0; i < tail; ++i) {
+        int v = order[i];
+        dist[v] = -1;
+        sigma[v] = 0;
+        delta[v] = 0;
+    }
+}
+
+// Betweenness of every vertex from the given sources (all n when src is
+// NULL), undirected: each s-t pair counted once. With a sample of k sources
+// the sums are scaled by n / k, an unbiased estimate of the exact values.
+// Sources are spread over threads; each thread accumulates into its own
+// array and the arrays are summed at the end.
+void betweenness(const Graph* g, const int* src, int k, double* bc) {
+    int n = g->n;
+    int count = src ? k : n;
+    double scale = (src && k > 0 ? (double)n / k : 1.0) / 2;
+    for (int v = 0; v < n; ++v) bc[v] = 0;
+#pragma omp parallel
+    {
+        int* dist = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+        int* order = (int*)malloc((size_t)n * sizeof(int) + sizeof(int));
+        double* sigma = (double*)calloc((size_t)n + 1, sizeof(double));
+        double* delta = (double*)calloc((size_t)n + 1, sizeof(double));
+        double* local = (double*)calloc((size_t)n + 1, sizeof(double));
+        for (int v = 0; v < n; ++v) dist[v] = -1;
+#pragma omp for schedule(dynamic, 1)
+        for (int i = 0; i < count; ++i) brandes_source(g, src ? src[i] : i, dist, sigma, delta, order, local);
+#pragma omp critical
+        for (int v = 0; v < n; ++v) bc[v] += local[v];
+        free(dist);
+        free(order);
+        free(sigma);
+        free(delta);
+        free(local);
+    }
+    for (int v = 0; v < n; ++v) bc[v] *= scale;
+}
+
+// Definition check on a small graph: sum over pairs s < t of the fraction of
+// shortest s-t paths through v, from all-pairs distances and path counts
+int betweenness_check(int n, long long E, uint64_t seed) {
+    Graph* g = graph_random(n, E, seed);
+    int* d = (int*)malloc((size_t)n * n * sizeof(int));
+    double* sg = (double*)calloc((size_t)n * n, sizeof(double));
+    int* queue = (int*)malloc((size_t)n * sizeof(int));
+    double* bc = (double*)malloc((size_t)n * sizeof(double));
+    int ok = 1;
+    for (int s = 0; s < n; ++s) {
+        int* ds = d + (size_t)s * n, head = 0, tail = 0;
+        double* ss = sg + (size_t)s * n;
+        for (int v = 0; v < n; ++v) ds[v] = -1;
+        ds[s] = 0;
+        ss[s] = 1;
+        queue[tail++] = s;
+        while (head < tail) {
+            int u = queue[head++];
+            for (int64_t e = g->offsets[u]; e < g->offsets[u + 1]; ++e) {
+                int v = g->nbrs[e];
+                if (ds[v] < 0) { ds[v] = ds[u] + 1; queue[tail++] = v; }
+                if (ds[v] == ds[u] + 1) ss[v] += ss[u];
+            }
+        }
+    }
+    betweenness(g, NULL, 0, bc);
+    for (int v = 0; v < n; ++v) {
+        double want = 0;
+        for (int s = 0; s < n; ++s)
+            for (int t = s + 1; t < n; ++t) {
+                int dst = d[(size_t)s * n + t], dsv = d[(size_t)s * n + v], dvt = d[(size_t)v * n + t];
+                if (s == v || t == v || dst < 0 || dsv < 0 || dvt < 0 || dsv + dvt != dst) continue;
+                want += sg[(size_t)s * n + v] * sg[(size_t)v * n + t] / sg[(size_t)s * n + t];
+            }
+        ok &= bc[v] > want - 1e-9 * (1 + want) && bc[v] < want + 1e-9 * (1 + want);
+    }
+    graph_free(g);
+    free(d);
+    free(sg);
+    free(queue);
+    free(bc);
+    return ok;
+}
+
+int cmp_score_desc(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x < y) - (x > y);
+}
+
+// Exact (samples == 0) or sampled betweenness; prints the top vertices.
+// With compare set, a sampled run also computes the exact values (all n
+// sources, so roughly n / samples times the sample's cost) to report the
+// error of the estimate.
+int run_bc_benchmark(const Graph* g, int samples, int compare) {
+    int n = g->n, ok = betweenness_check(200, 400, (uint64_t)time(NULL));
+    double* bc = (double*)malloc((size_t)n * sizeof(double) + sizeof(double));
+    int* src = NULL;
+    if (samples > 0) {
+        uint64_t seed = (uint64_t)time(NULL) ^ 0x42435342ULL;
+        src = (int*)malloc((size_t)samples * sizeof(int));
+        for (int i = 0; i < samples; ++i) src[i] = (int)(rng_next(&seed) % (uint64_t)n);
+    }
+    printf("Betweenness: n=%d, edges=%lld, %s, %d threads\n", n, g->m / 2,
+        samples > 0 ? "sampled sources" : "all sources", max_threads());
+    printf("Brandes matches the path-count definition on a 200-vertex graph: %s\n", ok ? "yes" : "NO");
+
+    double t0 = now_seconds();
+    betweenness(g, src, samples, bc);
+    double t = now_seconds() - t0;
+    int sources = samples > 0 ? samples : n;
+    printf("%d sources in %.3f s: %.3f ms/source, %.1f M TEPS\n", sources, t, t * 1e3 / (sources ? sources : 1),
+        t > 0 ? (double)sources * g->m / 2 / t / 1e6 : 0.0);
+
+    // top 10 by score: (score, vertex) pairs sorted descending
+    double* top = (double*)malloc((size_t)n * 2 * sizeof(double) + sizeof(double));
+    for (int v = 0; v < n; ++v) { top[2 * v] = bc[v]; top[2 * v + 1] = v; }
+    qsort(top, (size_t)n, 2 * sizeof(double), cmp_score_desc);
+    printf("Top vertices (vertex: score, degree):");
+    for (int i = 0; i < n && i < 10; ++i)
+        printf("%s %d: %.1f, %d", i ? ";" : "", (int)top[2 * i + 1], top[2 * i], graph_degree(g, (int)top[2 * i + 1]));
+    printf("\n");
+
+    if (samples > 0 && compare) {
+        double* exact = (double*)malloc((size_t)n * sizeof(double) + sizeof(double));
+        t0 = now_seconds();
+        betweenness(g, NULL, 0, exact);
+        double t_exact = now_seconds() - t0, err = 0;
+        int k = n < 100 ? n : 100, hits = 0;
+        double* etop = (double*)malloc((size_t)n * 2 * sizeof(double) + sizeof(double));
+        for (int v = 0; v < n; ++v) { etop[2 * v] = exact[v]; etop[2 * v + 1] = v; }
+        qsort(etop, (size_t)n, 2 * sizeof(double), cmp_score_desc);
+        for (int i = 0; i < k; ++i) {
+            int v = (int)etop[2 * i + 1];
+            double diff = bc[v] > exact[v] ? bc[v] - exact[v] : exact[v] - bc[v];
+            err += exact[v] > 0 ? diff / exact[v] : 0;
+            for (int j = 0; j < k; ++j) hits += (int)top[2 * j + 1] == v;
+        }
+        printf("Exact run: %.3f s (%.1fx the sample); top-%d mean relative error %.1f%%, %d of the true top-%d found\n",
+            t_exact, t > 0 ? t_exact / t : 0.0, k, k ? 100.0 * err / k : 0.0, hits, k);
+        free(exact);
+        free(etop);
+    }
+    free(top);
+    free(src);
+    free(bc);
+    return ok ? 0 : 1;
+}
+
+// usage: hw7 [seed]                         -> all-pairs paths on the N=10 demo graph
+//        hw7 bfs n m | grid side | file.bin [sources] -> direction-optimizing BFS benchmark
+//        hw7 apsp n m | grid side | file.bin [out]    -> MS-BFS all-pairs uint8 hop matrix
+//        hw7 pbfs n m | grid side | file.bin [sources] -> parallel BFS scaling vs serial
+//        hw7 query n m | grid side | file.bin queries.txt|count [out] -> bidirectional s-t queries
+//        hw7 oracle n m | grid side | file.bin [degree|random|pll] [k] [index] -> landmark distance oracle
+//        hw7 sssp n m | grid side | file.bin [max_weight] [sources] -> Dijkstra queues, delta-stepping
+//        hw7 smallbfs [deg] [graphs]                -> bitset BFS on 64/128/256-vertex graphs
+//        hw7 cc n m | grid side | file.bin [queries] -> parallel connected components
+//        hw7 bc n m | grid side | file.bin [samples] [exact] -> betweenness (0 = exact; exact = also report sampling error)
 int main(int argc, char* argv[]) {
+    if (argc >= 3 && strcmp(argv[1], "bfs") == 0) {
+        int used;
+        Graph* g = graph_from_args(argc - 2, argv + 2, &used);
+        if (!g) return 1;
+        int rc = run_bfs_benchmark(g, argc > 2 + used ? atoi(argv[2 + used]) : 8);
+        graph_free(g);
+        return rc;
+    }
+    if (argc >= 3 && strcmp(argv[1], "pbfs") == 0) {
+        int used;
+        Graph* g = graph_from_args(argc - 2, argv + 2, &used);
+        if (!g) return 1;
+        int rc = run_pbfs_benchmark(g, argc > 2 + used ? atoi(argv[2 + used]) : 8);
+        graph_free(g);
+        return rc;
+    }
+    if (argc >= 3 && strcmp(argv[1], "query") == 0) {
+        int used;
+        Graph* g = graph_from_args(argc - 2, argv + 2, &used);
+        if (!g) return 1;
+        int rc = run_query_benchmark(g, argc > 2 + used ? argv[2 + used] : "10000",
+            argc > 3 + used ? argv[3 + used] : NULL);
+        graph_free(g);
+        return rc;
+    }
+    if (argc >= 3 && strcmp(argv[1], "oracle") == 0) {
+        int used;
+        Graph* g = graph_from_args(argc - 2, argv + 2, &used);
+        if (!g) return 1;
+        const char* kind = argc > 2 + used ? argv[2 + used] : "degree";
+        int rc = run_oracle_benchmark(g, kind, argc > 3 + used ? atoi(argv[3 + used]) : 16,
+            argc > 4 + used ? argv[4 + used] : NULL);
+        graph_free(g);
+        return rc;
+    }
+    if (argc >= 3 && strcmp(argv[1], "sssp") == 0) {
+        int used;
+        Graph* g = graph_from_args(argc - 2, argv + 2, &used);
+        if (!g) return 1;
+        int rc = run_sssp_benchmark(g, argc > 2 + used ? atoi(argv[2 + used]) : 100,
+            argc > 3 + used ? atoi(argv[3 + used]) : 4);
+        graph_free(g);
+        return rc;
+    }
+    if (argc >= 2 && strcmp(argv[1], "smallbfs") == 0)
+        return run_smallbfs_benchmark(argc > 2 ? atof(argv[2]) : 3.0, argc > 3 ? atoi(argv[3]) : 2000);
+    if (argc >= 3 && strcmp(argv[1], "cc") == 0) {
+        int used;
+        Graph* g = graph_from_args(argc - 2, argv + 2, &used);
+        if (!g) return 1;
+        int rc = run_cc_benchmark(g, argc > 2 + used ? atoi(argv[2 + used]) : 10000);
+        graph_free(g);
+        return rc;
+    }
+    if (argc >= 3 && strcmp(argv[1], "bc") == 0) {
+        int used;
+        Graph* g = graph_from_args(argc - 2, argv + 2, &used);
+        if (!g) return 1;
+        int rc = run_bc_benchmark(g, argc > 2 + used ? atoi(argv[2 + used]) : 0,
+            argc > 3 + used && strcmp(argv[3 + used], "exact") == 0);
+        graph_free(g);
+        return rc;
+    }
+    if (argc >= 3 && strcmp(argv[1], "apsp") == 0) {
+        int used;
+        Graph* g = graph_from_args(argc - 2, argv + 2, &used);
+        if (!g) return 1;
+        int rc = run_apsp_benchmark(g, argc > 2 + used ? argv[2 + used] : NULL);
+        graph_free(g);
+        return rc;
+    }
+
     // You can pass a seed as an argument: e.g. ./a.out 123
     unsigned int seed = 0;
     if (argc >= 2) {